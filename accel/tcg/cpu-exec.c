@@ -238,6 +238,13 @@ static TranslationBlock *tb_htable_lookup(CPUState *cpu, vaddr pc,
     return qht_lookup_custom(&tb_ctx.htable, &desc, h, tb_lookup_cmp);
 }
 
+#ifdef CONFIG_DEBUG_TCG
+#define tb_jmp_cache_count(jc, field) \
+    qatomic_set(&(jc)->field, (jc)->field + 1)
+#else
+#define tb_jmp_cache_count(jc, field)  do { } while (0)
+#endif
+
 /* Might cause an exception, so have a longjmp destination ready */
 static inline TranslationBlock *tb_lookup(CPUState *cpu, vaddr pc,
                                           uint64_t cs_base, uint32_t flags,
@@ -262,12 +269,15 @@ static inline TranslationBlock *tb_lookup(CPUState *cpu, vaddr pc,
                    tb->cs_base == cs_base &&
                    tb->flags == flags &&
                    tb_cflags(tb) == cflags)) {
+            tb_jmp_cache_count(jc, hit_count);
             return tb;
         }
         tb = tb_htable_lookup(cpu, pc, cs_base, flags, cflags);
         if (tb == NULL) {
+            tb_jmp_cache_count(jc, miss_count);
             return NULL;
         }
+        tb_jmp_cache_count(jc, htable_hit_count);
         jc->array[hash].pc = pc;
         /* Ensure pc is written first. */
         qatomic_store_release(&jc->array[hash].tb, tb);
@@ -280,12 +290,15 @@ static inline TranslationBlock *tb_lookup(CPUState *cpu, vaddr pc,
                    tb->cs_base == cs_base &&
                    tb->flags == flags &&
                    tb_cflags(tb) == cflags)) {
+            tb_jmp_cache_count(jc, hit_count);
             return tb;
         }
         tb = tb_htable_lookup(cpu, pc, cs_base, flags, cflags);
         if (tb == NULL) {
+            tb_jmp_cache_count(jc, miss_count);
             return NULL;
         }
+        tb_jmp_cache_count(jc, htable_hit_count);
         /* Use the pc value already stored in tb->pc. */
         qatomic_set(&jc->array[hash].tb, tb);
     }
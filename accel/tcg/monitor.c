@@ -19,6 +19,7 @@
 #include "tcg/tcg.h"
 #include "internal-common.h"
 #include "tb-context.h"
+#include "tb-jmp-cache.h"
 
 
 static void dump_drift_info(GString *buf)
@@ -141,6 +142,50 @@ static void tlb_flush_counts(size_t *pfull, size_t *ppart, size_t *pelide)
     *pelide = elide;
 }
 
+static void tlb_victim_counts(size_t *phit, size_t *pmiss)
+{
+    CPUState *cpu;
+    size_t hit = 0, miss = 0;
+
+    CPU_FOREACH(cpu) {
+        hit += qatomic_read(&cpu->neg.tlb.c.victim_hit_count);
+        miss += qatomic_read(&cpu->neg.tlb.c.victim_miss_count);
+    }
+    *phit = hit;
+    *pmiss = miss;
+}
+
+#ifdef CONFIG_DEBUG_TCG
+static void dump_tb_jmp_cache_info(GString *buf)
+{
+    CPUState *cpu;
+    size_t hit = 0, htable = 0, miss = 0, total;
+
+    CPU_FOREACH(cpu) {
+        CPUJumpCache *jc = cpu->tb_jmp_cache;
+
+        if (jc) {
+            hit += qatomic_read(&jc->hit_count);
+            htable += qatomic_read(&jc->htable_hit_count);
+            miss += qatomic_read(&jc->miss_count);
+        }
+    }
+
+    total = hit + htable + miss;
+    g_string_append_printf(buf, "TB lookups          %zu\n", total);
+    g_string_append_printf(buf, "TB jmp cache hits   %zu (%zu%%)\n", hit,
+                           total ? (hit * 100) / total : 0);
+    g_string_append_printf(buf, "TB htable hits      %zu (%zu%%)\n", htable,
+                           total ? (htable * 100) / total : 0);
+    g_string_append_printf(buf, "TB lookup misses    %zu (%zu%%)\n", miss,
+                           total ? (miss * 100) / total : 0);
+}
+#else
+static void dump_tb_jmp_cache_info(GString *buf)
+{
+}
+#endif
+
 static void tcg_dump_info(GString *buf)
 {
     g_string_append_printf(buf, "[TCG profiler not compiled]\n");
@@ -151,6 +196,7 @@ static void dump_exec_info(GString *buf)
     struct tb_tree_stats tst = {};
     struct qht_stats hst;
     size_t nb_tbs, flush_full, flush_part, flush_elide;
+    size_t victim_hit, victim_miss;
 
     tcg_tb_foreach(tb_tree_stats_iter, &tst);
     nb_tbs = tst.nb_tbs;
@@ -191,11 +237,23 @@ static void dump_exec_info(GString *buf)
                            qatomic_read(&tb_ctx.tb_flush_count));
     g_string_append_printf(buf, "TB invalidate count %u\n",
                            qatomic_read(&tb_ctx.tb_phys_invalidate_count));
+    g_string_append_printf(buf, "TB SMC elided count %u\n",
+                           qatomic_read(
+                               &tb_ctx.tb_phys_invalidate_elide_count));
+
+    dump_tb_jmp_cache_info(buf);
 
     tlb_flush_counts(&flush_full, &flush_part, &flush_elide);
     g_string_append_printf(buf, "TLB full flushes    %zu\n", flush_full);
     g_string_append_printf(buf, "TLB partial flushes %zu\n", flush_part);
     g_string_append_printf(buf, "TLB elided flushes  %zu\n", flush_elide);
+
+    tlb_victim_counts(&victim_hit, &victim_miss);
+    g_string_append_printf(buf, "TLB victim hits     %zu (%zu%%)\n",
+                           victim_hit,
+                           victim_hit + victim_miss ?
+                           (victim_hit * 100) / (victim_hit + victim_miss) : 0);
+    g_string_append_printf(buf, "TLB victim misses   %zu\n", victim_miss);
     tcg_dump_info(buf);
 }
 
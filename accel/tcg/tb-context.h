@@ -35,6 +35,8 @@ struct TBContext {
     /* statistics */
     unsigned tb_flush_count;
     unsigned tb_phys_invalidate_count;
+    /* writes to pages holding code which overlapped no TB */
+    unsigned tb_phys_invalidate_elide_count;
 };
 
 extern TBContext tb_ctx;
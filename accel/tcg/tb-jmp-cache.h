@@ -19,6 +19,18 @@
  */
 struct CPUJumpCache {
     struct rcu_head rcu;
+#ifdef CONFIG_DEBUG_TCG
+    /*
+     * Statistics for tb_lookup, written only by the owning cpu and
+     * read atomically by the monitor: lookups satisfied by the array,
+     * lookups satisfied by the global htable, and lookups that failed.
+     * Kept out of release builds, as tb_lookup is on the path of every
+     * indirect branch through helper_lookup_tb_ptr.
+     */
+    size_t hit_count;
+    size_t htable_hit_count;
+    size_t miss_count;
+#endif
     struct {
         TranslationBlock *tb;
         vaddr pc;
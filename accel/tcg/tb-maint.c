@@ -1101,6 +1101,8 @@ tb_invalidate_phys_page_range__locked(struct page_collection *pages,
 {
     TranslationBlock *tb;
     PageForEachNext n;
+    bool any_tb = p->first_tb != 0;
+    bool any_invalidated = false;
 #ifdef TARGET_HAS_PRECISE_SMC
     bool current_tb_modified = false;
     TranslationBlock *current_tb = retaddr ? tcg_tb_lookup(retaddr) : NULL;
@@ -1141,9 +1143,20 @@ tb_invalidate_phys_page_range__locked(struct page_collection *pages,
             }
 #endif /* TARGET_HAS_PRECISE_SMC */
             tb_phys_invalidate__locked(tb);
+            any_invalidated = true;
         }
     }
 
+    /*
+     * Only TBs overlapping [start, last] are removed, so a write to the
+     * data portion of a page which also holds code costs the slow path
+     * but no retranslation.  Count these for "info jit".
+     */
+    if (any_tb && !any_invalidated) {
+        qatomic_set(&tb_ctx.tb_phys_invalidate_elide_count,
+                    tb_ctx.tb_phys_invalidate_elide_count + 1);
+    }
+
     /* if no code remaining, no need to continue to use slow writes */
     if (!p->first_tb) {
         tlb_unprotect_code(start);
@@ -19,11 +19,105 @@
 
 #include "qemu/osdep.h"
 #include "qemu/host-utils.h"
-#include "cpu.h"
+#include "qemu/bitops.h"
 #include "exec/helper-proto-common.h"
 #include "tcg/tcg-gvec-desc.h"
 
 
+#ifdef CONFIG_AVX2_OPT
+#include <immintrin.h>
+#include "host/cpuinfo.h"
+
+/*
+ * The out-of-line helpers are used when a vector is too long to be
+ * expanded inline, e.g. SVE with a large vector length.  The loops
+ * below are compiled for the baseline ISA, so when the host supports
+ * AVX2 the most common operations process the bulk of the vector
+ * 32 bytes at a time, leaving any tail to the generic loop.
+ */
+static bool gvec_avx2;
+
+static void __attribute__((constructor)) init_gvec_accel(void)
+{
+    gvec_avx2 = cpuinfo_init() & CPUINFO_AVX2;
+}
+
+#define ONES  _mm256_set1_epi64x(-1)
+
+#define DO_AVX2_2(NAME, OP)                                     \
+static intptr_t __attribute__((target("avx2")))                 \
+gvec_##NAME##_avx2(void *d, void *a, intptr_t oprsz)            \
+{                                                               \
+    intptr_t i;                                                 \
+                                                                \
+    for (i = 0; i + 32 <= oprsz; i += 32) {                     \
+        __m256i x = _mm256_loadu_si256(a + i);                  \
+        _mm256_storeu_si256(d + i, OP);                         \
+    }                                                           \
+    return i;                                                   \
+}
+
+#define DO_AVX2_3(NAME, OP)                                     \
+static intptr_t __attribute__((target("avx2")))                 \
+gvec_##NAME##_avx2(void *d, void *a, void *b, intptr_t oprsz)   \
+{                                                               \
+    intptr_t i;                                                 \
+                                                                \
+    for (i = 0; i + 32 <= oprsz; i += 32) {                     \
+        __m256i x = _mm256_loadu_si256(a + i);                  \
+        __m256i y = _mm256_loadu_si256(b + i);                  \
+        _mm256_storeu_si256(d + i, OP);                         \
+    }                                                           \
+    return i;                                                   \
+}
+
+DO_AVX2_2(not, _mm256_xor_si256(x, ONES))
+DO_AVX2_3(add8, _mm256_add_epi8(x, y))
+DO_AVX2_3(add16, _mm256_add_epi16(x, y))
+DO_AVX2_3(add32, _mm256_add_epi32(x, y))
+DO_AVX2_3(add64, _mm256_add_epi64(x, y))
+DO_AVX2_3(sub8, _mm256_sub_epi8(x, y))
+DO_AVX2_3(sub16, _mm256_sub_epi16(x, y))
+DO_AVX2_3(sub32, _mm256_sub_epi32(x, y))
+DO_AVX2_3(sub64, _mm256_sub_epi64(x, y))
+DO_AVX2_3(and, _mm256_and_si256(x, y))
+DO_AVX2_3(or, _mm256_or_si256(x, y))
+DO_AVX2_3(xor, _mm256_xor_si256(x, y))
+DO_AVX2_3(andc, _mm256_andnot_si256(y, x))
+DO_AVX2_3(orc, _mm256_or_si256(x, _mm256_xor_si256(y, ONES)))
+DO_AVX2_3(nand, _mm256_xor_si256(_mm256_and_si256(x, y), ONES))
+DO_AVX2_3(nor, _mm256_xor_si256(_mm256_or_si256(x, y), ONES))
+DO_AVX2_3(eqv, _mm256_xor_si256(_mm256_xor_si256(x, y), ONES))
+
+#undef DO_AVX2_2
+#undef DO_AVX2_3
+#undef ONES
+
+/* Return the number of bytes already processed.  */
+#define gvec_accel_2(NAME, d, a, oprsz) \
+    (gvec_avx2 && oprsz >= 32 ? gvec_##NAME##_avx2(d, a, oprsz) : 0)
+#define gvec_accel_3(NAME, d, a, b, oprsz) \
+    (gvec_avx2 && oprsz >= 32 ? gvec_##NAME##_avx2(d, a, b, oprsz) : 0)
+
+bool test_gvec_next_accel(void)
+{
+    if (gvec_avx2) {
+        gvec_avx2 = false;
+        return true;
+    }
+    init_gvec_accel();
+    return false;
+}
+#else
+#define gvec_accel_2(NAME, d, a, oprsz)     0
+#define gvec_accel_3(NAME, d, a, b, oprsz)  0
+
+bool test_gvec_next_accel(void)
+{
+    return false;
+}
+#endif /* CONFIG_AVX2_OPT */
+
 static inline void clear_high(void *d, intptr_t oprsz, uint32_t desc)
 {
     intptr_t maxsz = simd_maxsz(desc);
@@ -39,9 +133,9 @@ static inline void clear_high(void *d, intptr_t oprsz, uint32_t desc)
 void HELPER(gvec_add8)(void *d, void *a, void *b, uint32_t desc)
 {
     intptr_t oprsz = simd_oprsz(desc);
-    intptr_t i;
+    intptr_t i = gvec_accel_3(add8, d, a, b, oprsz);
 
-    for (i = 0; i < oprsz; i += sizeof(uint8_t)) {
+    for (; i < oprsz; i += sizeof(uint8_t)) {
         *(uint8_t *)(d + i) = *(uint8_t *)(a + i) + *(uint8_t *)(b + i);
     }
     clear_high(d, oprsz, desc);
@@ -50,9 +144,9 @@ void HELPER(gvec_add8)(void *d, void *a, void *b, uint32_t desc)
 void HELPER(gvec_add16)(void *d, void *a, void *b, uint32_t desc)
 {
     intptr_t oprsz = simd_oprsz(desc);
-    intptr_t i;
+    intptr_t i = gvec_accel_3(add16, d, a, b, oprsz);
 
-    for (i = 0; i < oprsz; i += sizeof(uint16_t)) {
+    for (; i < oprsz; i += sizeof(uint16_t)) {
         *(uint16_t *)(d + i) = *(uint16_t *)(a + i) + *(uint16_t *)(b + i);
     }
     clear_high(d, oprsz, desc);
@@ -61,9 +155,9 @@ void HELPER(gvec_add16)(void *d, void *a, void *b, uint32_t desc)
 void HELPER(gvec_add32)(void *d, void *a, void *b, uint32_t desc)
 {
     intptr_t oprsz = simd_oprsz(desc);
-    intptr_t i;
+    intptr_t i = gvec_accel_3(add32, d, a, b, oprsz);
 
-    for (i = 0; i < oprsz; i += sizeof(uint32_t)) {
+    for (; i < oprsz; i += sizeof(uint32_t)) {
         *(uint32_t *)(d + i) = *(uint32_t *)(a + i) + *(uint32_t *)(b + i);
     }
     clear_high(d, oprsz, desc);
@@ -72,9 +166,9 @@ void HELPER(gvec_add32)(void *d, void *a, void *b, uint32_t desc)
 void HELPER(gvec_add64)(void *d, void *a, void *b, uint32_t desc)
 {
     intptr_t oprsz = simd_oprsz(desc);
-    intptr_t i;
+    intptr_t i = gvec_accel_3(add64, d, a, b, oprsz);
 
-    for (i = 0; i < oprsz; i += sizeof(uint64_t)) {
+    for (; i < oprsz; i += sizeof(uint64_t)) {
         *(uint64_t *)(d + i) = *(uint64_t *)(a + i) + *(uint64_t *)(b + i);
     }
     clear_high(d, oprsz, desc);
@@ -127,9 +221,9 @@ void HELPER(gvec_adds64)(void *d, void *a, uint64_t b, uint32_t desc)
 void HELPER(gvec_sub8)(void *d, void *a, void *b, uint32_t desc)
 {
     intptr_t oprsz = simd_oprsz(desc);
-    intptr_t i;
+    intptr_t i = gvec_accel_3(sub8, d, a, b, oprsz);
 
-    for (i = 0; i < oprsz; i += sizeof(uint8_t)) {
+    for (; i < oprsz; i += sizeof(uint8_t)) {
         *(uint8_t *)(d + i) = *(uint8_t *)(a + i) - *(uint8_t *)(b + i);
     }
     clear_high(d, oprsz, desc);
@@ -138,9 +232,9 @@ void HELPER(gvec_sub8)(void *d, void *a, void *b, uint32_t desc)
 void HELPER(gvec_sub16)(void *d, void *a, void *b, uint32_t desc)
 {
     intptr_t oprsz = simd_oprsz(desc);
-    intptr_t i;
+    intptr_t i = gvec_accel_3(sub16, d, a, b, oprsz);
 
-    for (i = 0; i < oprsz; i += sizeof(uint16_t)) {
+    for (; i < oprsz; i += sizeof(uint16_t)) {
         *(uint16_t *)(d + i) = *(uint16_t *)(a + i) - *(uint16_t *)(b + i);
     }
     clear_high(d, oprsz, desc);
@@ -149,9 +243,9 @@ void HELPER(gvec_sub16)(void *d, void *a, void *b, uint32_t desc)
 void HELPER(gvec_sub32)(void *d, void *a, void *b, uint32_t desc)
 {
     intptr_t oprsz = simd_oprsz(desc);
-    intptr_t i;
+    intptr_t i = gvec_accel_3(sub32, d, a, b, oprsz);
 
-    for (i = 0; i < oprsz; i += sizeof(uint32_t)) {
+    for (; i < oprsz; i += sizeof(uint32_t)) {
         *(uint32_t *)(d + i) = *(uint32_t *)(a + i) - *(uint32_t *)(b + i);
     }
     clear_high(d, oprsz, desc);
@@ -160,9 +254,9 @@ void HELPER(gvec_sub32)(void *d, void *a, void *b, uint32_t desc)
 void HELPER(gvec_sub64)(void *d, void *a, void *b, uint32_t desc)
 {
     intptr_t oprsz = simd_oprsz(desc);
-    intptr_t i;
+    intptr_t i = gvec_accel_3(sub64, d, a, b, oprsz);
 
-    for (i = 0; i < oprsz; i += sizeof(uint64_t)) {
+    for (; i < oprsz; i += sizeof(uint64_t)) {
         *(uint64_t *)(d + i) = *(uint64_t *)(a + i) - *(uint64_t *)(b + i);
     }
     clear_high(d, oprsz, desc);
@@ -443,9 +537,9 @@ void HELPER(gvec_dup8)(void *d, uint32_t desc, uint32_t c)
 void HELPER(gvec_not)(void *d, void *a, uint32_t desc)
 {
     intptr_t oprsz = simd_oprsz(desc);
-    intptr_t i;
+    intptr_t i = gvec_accel_2(not, d, a, oprsz);
 
-    for (i = 0; i < oprsz; i += sizeof(uint64_t)) {
+    for (; i < oprsz; i += sizeof(uint64_t)) {
         *(uint64_t *)(d + i) = ~*(uint64_t *)(a + i);
     }
     clear_high(d, oprsz, desc);
@@ -454,9 +548,9 @@ void HELPER(gvec_not)(void *d, void *a, uint32_t desc)
 void HELPER(gvec_and)(void *d, void *a, void *b, uint32_t desc)
 {
     intptr_t oprsz = simd_oprsz(desc);
-    intptr_t i;
+    intptr_t i = gvec_accel_3(and, d, a, b, oprsz);
 
-    for (i = 0; i < oprsz; i += sizeof(uint64_t)) {
+    for (; i < oprsz; i += sizeof(uint64_t)) {
         *(uint64_t *)(d + i) = *(uint64_t *)(a + i) & *(uint64_t *)(b + i);
     }
     clear_high(d, oprsz, desc);
@@ -465,9 +559,9 @@ void HELPER(gvec_and)(void *d, void *a, void *b, uint32_t desc)
 void HELPER(gvec_or)(void *d, void *a, void *b, uint32_t desc)
 {
     intptr_t oprsz = simd_oprsz(desc);
-    intptr_t i;
+    intptr_t i = gvec_accel_3(or, d, a, b, oprsz);
 
-    for (i = 0; i < oprsz; i += sizeof(uint64_t)) {
+    for (; i < oprsz; i += sizeof(uint64_t)) {
         *(uint64_t *)(d + i) = *(uint64_t *)(a + i) | *(uint64_t *)(b + i);
     }
     clear_high(d, oprsz, desc);
@@ -476,9 +570,9 @@ void HELPER(gvec_or)(void *d, void *a, void *b, uint32_t desc)
 void HELPER(gvec_xor)(void *d, void *a, void *b, uint32_t desc)
 {
     intptr_t oprsz = simd_oprsz(desc);
-    intptr_t i;
+    intptr_t i = gvec_accel_3(xor, d, a, b, oprsz);
 
-    for (i = 0; i < oprsz; i += sizeof(uint64_t)) {
+    for (; i < oprsz; i += sizeof(uint64_t)) {
         *(uint64_t *)(d + i) = *(uint64_t *)(a + i) ^ *(uint64_t *)(b + i);
     }
     clear_high(d, oprsz, desc);
@@ -487,9 +581,9 @@ void HELPER(gvec_xor)(void *d, void *a, void *b, uint32_t desc)
 void HELPER(gvec_andc)(void *d, void *a, void *b, uint32_t desc)
 {
     intptr_t oprsz = simd_oprsz(desc);
-    intptr_t i;
+    intptr_t i = gvec_accel_3(andc, d, a, b, oprsz);
 
-    for (i = 0; i < oprsz; i += sizeof(uint64_t)) {
+    for (; i < oprsz; i += sizeof(uint64_t)) {
         *(uint64_t *)(d + i) = *(uint64_t *)(a + i) &~ *(uint64_t *)(b + i);
     }
     clear_high(d, oprsz, desc);
@@ -498,9 +592,9 @@ void HELPER(gvec_andc)(void *d, void *a, void *b, uint32_t desc)
 void HELPER(gvec_orc)(void *d, void *a, void *b, uint32_t desc)
 {
     intptr_t oprsz = simd_oprsz(desc);
-    intptr_t i;
+    intptr_t i = gvec_accel_3(orc, d, a, b, oprsz);
 
-    for (i = 0; i < oprsz; i += sizeof(uint64_t)) {
+    for (; i < oprsz; i += sizeof(uint64_t)) {
         *(uint64_t *)(d + i) = *(uint64_t *)(a + i) |~ *(uint64_t *)(b + i);
     }
     clear_high(d, oprsz, desc);
@@ -509,9 +603,9 @@ void HELPER(gvec_orc)(void *d, void *a, void *b, uint32_t desc)
 void HELPER(gvec_nand)(void *d, void *a, void *b, uint32_t desc)
 {
     intptr_t oprsz = simd_oprsz(desc);
-    intptr_t i;
+    intptr_t i = gvec_accel_3(nand, d, a, b, oprsz);
 
-    for (i = 0; i < oprsz; i += sizeof(uint64_t)) {
+    for (; i < oprsz; i += sizeof(uint64_t)) {
         *(uint64_t *)(d + i) = ~(*(uint64_t *)(a + i) & *(uint64_t *)(b + i));
     }
     clear_high(d, oprsz, desc);
@@ -520,9 +614,9 @@ void HELPER(gvec_nand)(void *d, void *a, void *b, uint32_t desc)
 void HELPER(gvec_nor)(void *d, void *a, void *b, uint32_t desc)
 {
     intptr_t oprsz = simd_oprsz(desc);
-    intptr_t i;
+    intptr_t i = gvec_accel_3(nor, d, a, b, oprsz);
 
-    for (i = 0; i < oprsz; i += sizeof(uint64_t)) {
+    for (; i < oprsz; i += sizeof(uint64_t)) {
         *(uint64_t *)(d + i) = ~(*(uint64_t *)(a + i) | *(uint64_t *)(b + i));
     }
     clear_high(d, oprsz, desc);
@@ -531,9 +625,9 @@ void HELPER(gvec_nor)(void *d, void *a, void *b, uint32_t desc)
 void HELPER(gvec_eqv)(void *d, void *a, void *b, uint32_t desc)
 {
     intptr_t oprsz = simd_oprsz(desc);
-    intptr_t i;
+    intptr_t i = gvec_accel_3(eqv, d, a, b, oprsz);
 
-    for (i = 0; i < oprsz; i += sizeof(uint64_t)) {
+    for (; i < oprsz; i += sizeof(uint64_t)) {
         *(uint64_t *)(d + i) = ~(*(uint64_t *)(a + i) ^ *(uint64_t *)(b + i));
     }
     clear_high(d, oprsz, desc);
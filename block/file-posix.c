@@ -160,6 +160,8 @@ typedef struct BDRVRawState {
     bool has_write_zeroes:1;
     bool use_linux_aio:1;
     bool use_linux_io_uring:1;
+    /* registered file slot of fd in the io_uring of the AioContext, or -1 */
+    int luring_fixed_file;
     int page_cache_inconsistent; /* errno from fdatasync failure */
     bool has_fallocate;
     bool needs_alignment;
@@ -591,6 +593,51 @@ static QemuOptsList raw_runtime_opts = {
 
 static const char *const mutable_opts[] = { "x-check-cache-dropped", NULL };
 
+/*
+ * With aio=io_uring, s->fd is registered with the io_uring of the node's
+ * AioContext, so that requests submitted from there can use a fixed file.
+ * It has to be unregistered before s->fd is closed or the node moves to
+ * another AioContext.
+ */
+static void raw_luring_register_fd(BlockDriverState *bs)
+{
+#ifdef CONFIG_LINUX_IO_URING
+    BDRVRawState *s = bs->opaque;
+
+    assert(s->luring_fixed_file < 0);
+    if (s->use_linux_io_uring && s->fd >= 0) {
+        s->luring_fixed_file = luring_register_fd(
+            aio_get_linux_io_uring(bdrv_get_aio_context(bs)), s->fd);
+    }
+#endif
+}
+
+static void raw_luring_unregister_fd(BlockDriverState *bs)
+{
+#ifdef CONFIG_LINUX_IO_URING
+    BDRVRawState *s = bs->opaque;
+
+    if (s->luring_fixed_file >= 0) {
+        luring_unregister_fd(aio_get_linux_io_uring(bdrv_get_aio_context(bs)),
+                             s->luring_fixed_file);
+        s->luring_fixed_file = -1;
+    }
+#endif
+}
+
+#ifdef CONFIG_LINUX_IO_URING
+/* The registered file slot is only valid in the node's own AioContext */
+static int raw_luring_fixed_file(BlockDriverState *bs)
+{
+    BDRVRawState *s = bs->opaque;
+
+    if (qemu_get_current_aio_context() != bdrv_get_aio_context(bs)) {
+        return -1;
+    }
+    return s->luring_fixed_file;
+}
+#endif
+
 static int raw_open_common(BlockDriverState *bs, QDict *options,
                            int bdrv_flags, int open_flags,
                            bool device, Error **errp)
@@ -690,6 +737,7 @@ static int raw_open_common(BlockDriverState *bs, QDict *options,
     raw_parse_flags(bdrv_flags, &s->open_flags, false);
 
     s->fd = -1;
+    s->luring_fixed_file = -1;
     fd = qemu_open(filename, s->open_flags, errp);
     ret = fd < 0 ? -errno : 0;
 
@@ -821,6 +869,7 @@ static int raw_open_common(BlockDriverState *bs, QDict *options,
         /* When extending regular files, we get zeros from the OS */
         bs->supported_truncate_flags = BDRV_REQ_ZERO_WRITE;
     }
+    raw_luring_register_fd(bs);
     ret = 0;
 fail:
     if (ret < 0 && s->fd != -1) {
@@ -2479,7 +2528,8 @@ static int coroutine_fn raw_co_prw(BlockDriverState *bs, int64_t *offset_ptr,
 #ifdef CONFIG_LINUX_IO_URING
     } else if (s->use_linux_io_uring) {
         assert(qiov->size == bytes);
-        ret = luring_co_submit(bs, s->fd, offset, qiov, type);
+        ret = luring_co_submit(bs, s->fd, raw_luring_fixed_file(bs), offset,
+                               qiov, type);
         goto out;
 #endif
 #ifdef CONFIG_LINUX_AIO
@@ -2571,12 +2621,18 @@ static int coroutine_fn raw_co_flush_to_disk(BlockDriverState *bs)
 
 #ifdef CONFIG_LINUX_IO_URING
     if (s->use_linux_io_uring) {
-        return luring_co_submit(bs, s->fd, 0, NULL, QEMU_AIO_FLUSH);
+        return luring_co_submit(bs, s->fd, raw_luring_fixed_file(bs), 0, NULL,
+                                QEMU_AIO_FLUSH);
     }
 #endif
     return raw_thread_pool_submit(handle_aiocb_flush, &acb);
 }
 
+static void raw_aio_detach_aio_context(BlockDriverState *bs)
+{
+    raw_luring_unregister_fd(bs);
+}
+
 static void raw_aio_attach_aio_context(BlockDriverState *bs,
                                        AioContext *new_context)
 {
@@ -2601,6 +2657,7 @@ static void raw_aio_attach_aio_context(BlockDriverState *bs,
         }
     }
 #endif
+    raw_luring_register_fd(bs);
 }
 
 static void raw_close(BlockDriverState *bs)
@@ -2611,6 +2668,7 @@ static void raw_close(BlockDriverState *bs)
 #if defined(CONFIG_BLKZONED)
         g_free(bs->wps);
 #endif
+        raw_luring_unregister_fd(bs);
         qemu_close(s->fd);
         s->fd = -1;
     }
@@ -3833,9 +3891,11 @@ static void raw_set_perm(BlockDriverState *bs, uint64_t perm, uint64_t shared)
     /* For reopen, we have already switched to the new fd (.bdrv_set_perm is
      * called after .bdrv_reopen_commit) */
     if (s->perm_change_fd && s->fd != s->perm_change_fd) {
+        raw_luring_unregister_fd(bs);
         qemu_close(s->fd);
         s->fd = s->perm_change_fd;
         s->open_flags = s->perm_change_flags;
+        raw_luring_register_fd(bs);
     }
     s->perm_change_fd = 0;
 
@@ -3930,6 +3990,7 @@ BlockDriver bdrv_file = {
     .bdrv_co_copy_range_from = raw_co_copy_range_from,
     .bdrv_co_copy_range_to  = raw_co_copy_range_to,
     .bdrv_refresh_limits = raw_refresh_limits,
+    .bdrv_detach_aio_context = raw_aio_detach_aio_context,
     .bdrv_attach_aio_context = raw_aio_attach_aio_context,
 
     .bdrv_co_truncate                   = raw_co_truncate,
@@ -4300,6 +4361,7 @@ static BlockDriver bdrv_host_device = {
     .bdrv_co_copy_range_from = raw_co_copy_range_from,
     .bdrv_co_copy_range_to  = raw_co_copy_range_to,
     .bdrv_refresh_limits = raw_refresh_limits,
+    .bdrv_detach_aio_context = raw_aio_detach_aio_context,
     .bdrv_attach_aio_context = raw_aio_attach_aio_context,
 
     .bdrv_co_truncate                   = raw_co_truncate,
@@ -4436,6 +4498,7 @@ static BlockDriver bdrv_host_cdrom = {
     .bdrv_co_pwritev        = raw_co_pwritev,
     .bdrv_co_flush_to_disk  = raw_co_flush_to_disk,
     .bdrv_refresh_limits    = cdrom_refresh_limits,
+    .bdrv_detach_aio_context = raw_aio_detach_aio_context,
     .bdrv_attach_aio_context = raw_aio_attach_aio_context,
 
     .bdrv_co_truncate                   = raw_co_truncate,
@@ -4562,6 +4625,7 @@ static BlockDriver bdrv_host_cdrom = {
     .bdrv_co_pwritev        = raw_co_pwritev,
     .bdrv_co_flush_to_disk  = raw_co_flush_to_disk,
     .bdrv_refresh_limits    = cdrom_refresh_limits,
+    .bdrv_detach_aio_context = raw_aio_detach_aio_context,
     .bdrv_attach_aio_context = raw_aio_attach_aio_context,
 
     .bdrv_co_truncate                   = raw_co_truncate,
@@ -16,6 +16,8 @@
 #include "block/raw-aio.h"
 #include "qemu/coroutine.h"
 #include "qemu/defer-call.h"
+#include "qemu/error-report.h"
+#include "qemu/thread.h"
 #include "qapi/error.h"
 #include "sysemu/block-backend.h"
 #include "trace.h"
@@ -26,6 +28,9 @@
 /* io_uring ring size */
 #define MAX_ENTRIES 128
 
+/* Number of slots in the registered file table */
+#define MAX_FIXED_FILES 64
+
 typedef struct LuringAIOCB {
     Coroutine *co;
     struct io_uring_sqe sqeq;
@@ -58,6 +63,16 @@ typedef struct LuringState {
     LuringQueue io_q;
 
     QEMUBH *completion_bh;
+
+    /*
+     * Registered file table.  fixed_files[i] is the fd registered in slot i,
+     * or -1 if the slot is free.  The submission path does not look at it,
+     * callers of luring_co_submit() pass the slot returned by
+     * luring_register_fd() instead.
+     */
+    bool has_fixed_files;
+    QemuMutex fixed_files_lock;
+    int fixed_files[MAX_FIXED_FILES]; /* protected by fixed_files_lock */
 } LuringState;
 
 /**
@@ -326,6 +341,7 @@ static void luring_deferred_fn(void *opaque)
 /**
  * luring_do_submit:
  * @fd: file descriptor for I/O
+ * @fixed_file: registered file table slot of @fd, or -1
  * @luringcb: AIO control block
  * @s: AIO state
  * @offset: offset for request
@@ -334,12 +350,17 @@ static void luring_deferred_fn(void *opaque)
  * Fetches sqes from ring, adds to pending queue and preps them
  *
  */
-static int luring_do_submit(int fd, LuringAIOCB *luringcb, LuringState *s,
-                            uint64_t offset, int type)
+static int luring_do_submit(int fd, int fixed_file, LuringAIOCB *luringcb,
+                            LuringState *s, uint64_t offset, int type)
 {
     int ret;
     struct io_uring_sqe *sqes = &luringcb->sqeq;
 
+    /* Let the kernel skip the fd table lookup and file refcounting */
+    if (fixed_file >= 0) {
+        fd = fixed_file;
+    }
+
     switch (type) {
     case QEMU_AIO_WRITE:
         io_uring_prep_writev(sqes, fd, luringcb->qiov->iov,
@@ -361,6 +382,9 @@ static int luring_do_submit(int fd, LuringAIOCB *luringcb, LuringState *s,
                         __func__, type);
         abort();
     }
+    if (fixed_file >= 0) {
+        sqes->flags |= IOSQE_FIXED_FILE;
+    }
     io_uring_sqe_set_data(sqes, luringcb);
 
     QSIMPLEQ_INSERT_TAIL(&s->io_q.submit_queue, luringcb, next);
@@ -379,8 +403,9 @@ static int luring_do_submit(int fd, LuringAIOCB *luringcb, LuringState *s,
     return 0;
 }
 
-int coroutine_fn luring_co_submit(BlockDriverState *bs, int fd, uint64_t offset,
-                                  QEMUIOVector *qiov, int type)
+int coroutine_fn luring_co_submit(BlockDriverState *bs, int fd, int fixed_file,
+                                  uint64_t offset, QEMUIOVector *qiov,
+                                  int type)
 {
     int ret;
     AioContext *ctx = qemu_get_current_aio_context();
@@ -393,7 +418,7 @@ int coroutine_fn luring_co_submit(BlockDriverState *bs, int fd, uint64_t offset,
     };
     trace_luring_co_submit(bs, s, &luringcb, fd, offset, qiov ? qiov->size : 0,
                            type);
-    ret = luring_do_submit(fd, &luringcb, s, offset, type);
+    ret = luring_do_submit(fd, fixed_file, &luringcb, s, offset, type);
 
     if (ret < 0) {
         return ret;
@@ -422,15 +447,123 @@ void luring_attach_aio_context(LuringState *s, AioContext *new_context)
                        qemu_luring_poll_cb, qemu_luring_poll_ready, s);
 }
 
-LuringState *luring_init(Error **errp)
+/**
+ * luring_register_fd:
+ * @s: AIO state
+ * @fd: file descriptor
+ *
+ * Add @fd to the registered file table of @s.  Requests on @fd that are
+ * submitted in this AioContext can then pass the returned slot to
+ * luring_co_submit() and use IOSQE_FIXED_FILE.  This is only an optimization;
+ * if the table is full or the kernel does not support it, requests keep using
+ * @fd directly.
+ *
+ * The caller must call luring_unregister_fd() before closing @fd.
+ *
+ * Returns the registered file table slot, or -1 if @fd was not registered.
+ */
+int luring_register_fd(LuringState *s, int fd)
+{
+    int i, rc;
+    int slot = -1;
+
+    if (!s->has_fixed_files) {
+        return -1;
+    }
+
+    qemu_mutex_lock(&s->fixed_files_lock);
+    for (i = 0; i < MAX_FIXED_FILES; i++) {
+        if (s->fixed_files[i] == -1) {
+            rc = io_uring_register_files_update(&s->ring, i, &fd, 1);
+            trace_luring_update_fixed_file(s, i, fd, rc);
+            if (rc == 1) {
+                s->fixed_files[i] = fd;
+                slot = i;
+            }
+            break;
+        }
+    }
+    qemu_mutex_unlock(&s->fixed_files_lock);
+
+    return slot;
+}
+
+/**
+ * luring_unregister_fd:
+ * @s: AIO state
+ * @slot: slot returned by luring_register_fd(), or -1
+ *
+ * Remove a file from the registered file table of @s.  There must be no
+ * requests in flight that use @slot.
+ */
+void luring_unregister_fd(LuringState *s, int slot)
+{
+    int fd = -1;
+    int rc;
+
+    if (slot < 0) {
+        return;
+    }
+
+    qemu_mutex_lock(&s->fixed_files_lock);
+    assert(s->fixed_files[slot] >= 0);
+    rc = io_uring_register_files_update(&s->ring, slot, &fd, 1);
+    trace_luring_update_fixed_file(s, slot, fd, rc);
+    if (rc == 1) {
+        s->fixed_files[slot] = -1;
+    } else {
+        /* Keep the slot out of use, the kernel still holds the file */
+        s->fixed_files[slot] = -2;
+    }
+    qemu_mutex_unlock(&s->fixed_files_lock);
+}
+
+/*
+ * Set up @ring with a kernel thread that polls the submission queue, so that
+ * submitting requests does not need a system call while the thread is awake.
+ * Only rings that accept requests on plain file descriptors are kept, because
+ * requests from other AioContexts do not use registered files.
+ */
+static bool luring_init_sqpoll(struct io_uring *ring, unsigned int idle)
 {
+#ifdef IORING_FEAT_SQPOLL_NONFIXED
+    struct io_uring_params params = {
+        .flags = IORING_SETUP_SQPOLL,
+        .sq_thread_idle = idle,
+    };
     int rc;
+
+    rc = io_uring_queue_init_params(MAX_ENTRIES, ring, &params);
+    if (rc < 0) {
+        warn_report("io_uring submission queue polling is not available: %s",
+                    strerror(-rc));
+        return false;
+    }
+    if (!(params.features & IORING_FEAT_SQPOLL_NONFIXED)) {
+        warn_report("io_uring submission queue polling needs Linux 5.11 "
+                    "or later");
+        io_uring_queue_exit(ring);
+        return false;
+    }
+    return true;
+#else
+    warn_report("io_uring submission queue polling is not supported "
+                "by this build");
+    return false;
+#endif
+}
+
+LuringState *luring_init(unsigned int sqpoll_idle, Error **errp)
+{
+    int rc = 0, i;
     LuringState *s = g_new0(LuringState, 1);
     struct io_uring *ring = &s->ring;
 
     trace_luring_init_state(s, sizeof(*s));
 
-    rc = io_uring_queue_init(MAX_ENTRIES, ring, 0);
+    if (!sqpoll_idle || !luring_init_sqpoll(ring, sqpoll_idle)) {
+        rc = io_uring_queue_init(MAX_ENTRIES, ring, 0);
+    }
     if (rc < 0) {
         error_setg_errno(errp, errno, "failed to init linux io_uring ring");
         g_free(s);
@@ -438,12 +571,24 @@ LuringState *luring_init(Error **errp)
     }
 
     ioq_init(&s->io_q);
+
+    /*
+     * Start with an empty registered file table.  Sparse tables need Linux
+     * 5.5 or later; without them all requests use plain file descriptors.
+     */
+    for (i = 0; i < MAX_FIXED_FILES; i++) {
+        s->fixed_files[i] = -1;
+    }
+    s->has_fixed_files =
+        io_uring_register_files(ring, s->fixed_files, MAX_FIXED_FILES) == 0;
+    qemu_mutex_init(&s->fixed_files_lock);
     return s;
 
 }
 
 void luring_cleanup(LuringState *s)
 {
+    qemu_mutex_destroy(&s->fixed_files_lock);
     io_uring_queue_exit(&s->ring);
     trace_luring_cleanup_state(s);
     g_free(s);
@@ -964,12 +964,76 @@ int qcow2_update_cluster_refcount(BlockDriverState *bs,
 
 
 
+/*
+ * Counts the clusters with a refcount of 0 starting at @cluster_index, looking
+ * at no more than @nb_clusters and not beyond the refcount block that covers
+ * @cluster_index.  This needs only one refcount block cache lookup where
+ * calling qcow2_get_refcount() for each cluster would need one per cluster.
+ *
+ * *@found_used is set if the count was stopped by a cluster in use, which is
+ * then the cluster at @cluster_index + *@nb_free.
+ *
+ * Returns 0 on success, -errno on error.
+ */
+static int GRAPH_RDLOCK
+count_free_clusters(BlockDriverState *bs, uint64_t cluster_index,
+                    uint64_t nb_clusters, uint64_t *nb_free, bool *found_used)
+{
+    BDRVQcow2State *s = bs->opaque;
+    uint64_t refcount_table_index, block_index, i;
+    int64_t refcount_block_offset;
+    void *refcount_block;
+    int ret;
+
+    refcount_table_index = cluster_index >> s->refcount_block_bits;
+    block_index = cluster_index & (s->refcount_block_size - 1);
+    nb_clusters = MIN(nb_clusters, s->refcount_block_size - block_index);
+    *found_used = false;
+
+    if (refcount_table_index >= s->refcount_table_size) {
+        *nb_free = nb_clusters;
+        return 0;
+    }
+    refcount_block_offset =
+        s->refcount_table[refcount_table_index] & REFT_OFFSET_MASK;
+    if (!refcount_block_offset) {
+        *nb_free = nb_clusters;
+        return 0;
+    }
+
+    if (offset_into_cluster(s, refcount_block_offset)) {
+        qcow2_signal_corruption(bs, true, -1, -1, "Refblock offset %#" PRIx64
+                                " unaligned (reftable index: %#" PRIx64 ")",
+                                refcount_block_offset, refcount_table_index);
+        return -EIO;
+    }
+
+    ret = qcow2_cache_get(bs, s->refcount_block_cache, refcount_block_offset,
+                          &refcount_block);
+    if (ret < 0) {
+        return ret;
+    }
+
+    for (i = 0; i < nb_clusters; i++) {
+        if (s->get_refcount(refcount_block, block_index + i) != 0) {
+            *found_used = true;
+            break;
+        }
+    }
+
+    qcow2_cache_put(s->refcount_block_cache, &refcount_block);
+
+    *nb_free = i;
+    return 0;
+}
+
 /* return < 0 if error */
 static int64_t GRAPH_RDLOCK
 alloc_clusters_noref(BlockDriverState *bs, uint64_t size, uint64_t max)
 {
     BDRVQcow2State *s = bs->opaque;
-    uint64_t i, nb_clusters, refcount;
+    uint64_t i, nb_clusters, nb_free;
+    bool found_used;
     int ret;
 
     /* We can't allocate clusters if they may still be queued for discard. */
@@ -979,13 +1043,17 @@ alloc_clusters_noref(BlockDriverState *bs, uint64_t size, uint64_t max)
 
     nb_clusters = size_to_clusters(s, size);
 retry:
-    for(i = 0; i < nb_clusters; i++) {
-        uint64_t next_cluster_index = s->free_cluster_index++;
-        ret = qcow2_get_refcount(bs, next_cluster_index, &refcount);
-
+    for (i = 0; i < nb_clusters; i += nb_free) {
+        ret = count_free_clusters(bs, s->free_cluster_index, nb_clusters - i,
+                                  &nb_free, &found_used);
         if (ret < 0) {
             return ret;
-        } else if (refcount != 0) {
+        }
+
+        s->free_cluster_index += nb_free;
+        if (found_used) {
+            /* Skip the used cluster and look for a new free range after it */
+            s->free_cluster_index++;
             goto retry;
         }
     }
@@ -20,6 +20,7 @@
 typedef struct {
     const char *name;
     ptrdiff_t offset; /* field's byte offset in EventLoopBase struct */
+    int64_t max; /* maximum value, 0 means INT64_MAX */
 } EventLoopBaseParamInfo;
 
 static void event_loop_base_instance_init(Object *obj)
@@ -32,6 +33,9 @@ static void event_loop_base_instance_init(Object *obj)
 static EventLoopBaseParamInfo aio_max_batch_info = {
     "aio-max-batch", offsetof(EventLoopBase, aio_max_batch),
 };
+static EventLoopBaseParamInfo aio_sqpoll_idle_info = {
+    "aio-sqpoll-idle", offsetof(EventLoopBase, aio_sqpoll_idle), UINT32_MAX,
+};
 static EventLoopBaseParamInfo thread_pool_min_info = {
     "thread-pool-min", offsetof(EventLoopBase, thread_pool_min),
 };
@@ -56,15 +60,16 @@ static void event_loop_base_set_param(Object *obj, Visitor *v,
     EventLoopBase *base = EVENT_LOOP_BASE(obj);
     EventLoopBaseParamInfo *info = opaque;
     int64_t *field = (void *)base + info->offset;
+    int64_t max = info->max ? info->max : INT64_MAX;
     int64_t value;
 
     if (!visit_type_int64(v, name, &value, errp)) {
         return;
     }
 
-    if (value < 0) {
+    if (value < 0 || value > max) {
         error_setg(errp, "%s value must be in range [0, %" PRId64 "]",
-                   info->name, INT64_MAX);
+                   info->name, max);
         return;
     }
 
@@ -109,6 +114,10 @@ static void event_loop_base_class_init(ObjectClass *klass, void *class_data)
                               event_loop_base_get_param,
                               event_loop_base_set_param,
                               NULL, &aio_max_batch_info);
+    object_class_property_add(klass, "aio-sqpoll-idle", "int",
+                              event_loop_base_get_param,
+                              event_loop_base_set_param,
+                              NULL, &aio_sqpoll_idle_info);
     object_class_property_add(klass, "thread-pool-min", "int",
                               event_loop_base_get_param,
                               event_loop_base_set_param,
@@ -2825,7 +2825,8 @@ float16 float64_to_float16(float64 a, bool ieee, float_status *s)
     return float16a_round_pack_canonical(&p, s, fmt);
 }
 
-float32 float64_to_float32(float64 a, float_status *s)
+static float32 QEMU_SOFTFLOAT_ATTR
+soft_float64_to_float32(float64 a, float_status *s)
 {
     FloatParts64 p;
 
@@ -2834,6 +2835,33 @@ float32 float64_to_float32(float64 a, float_status *s)
     return float32_round_pack_canonical(&p, s);
 }
 
+float32 float64_to_float32(float64 a, float_status *s)
+{
+    if (likely(float64_is_normal(a))) {
+        int exp = extract64(float64_val(a), 52, 11) - 1023;
+
+        /*
+         * The result is a float32 normal.  Narrowing is exact if the
+         * low 29 bits of the fraction are zero, and may then be done
+         * on the host irrespective of rounding mode and flags.
+         * Otherwise the host result is correct only under the usual
+         * hardfloat conditions, and only if rounding up cannot overflow.
+         */
+        if (exp >= -126 && exp <= 127 &&
+            (extract64(float64_val(a), 0, 29) == 0 ||
+             (exp < 127 && can_use_fpu(s)))) {
+            union_float32 uf;
+            union_float64 ud;
+            ud.s = a;
+            uf.h = ud.h;
+            return uf.s;
+        }
+    } else if (float64_is_zero(a)) {
+        return float32_set_sign(float32_zero, float64_is_neg(a));
+    }
+    return soft_float64_to_float32(a, s);
+}
+
 float32 bfloat16_to_float32(bfloat16 a, float_status *s)
 {
     FloatParts64 p;
@@ -4279,10 +4307,42 @@ static bfloat16 bfloat16_minmax(bfloat16 a, bfloat16 b,
     return bfloat16_round_pack_canonical(pr, s);
 }
 
+/*
+ * When neither input is a NaN or denormal, the result of minmax is one
+ * of the inputs unchanged and no exception can be raised.  For such
+ * inputs, comparing the magnitude bits of the encodings orders them
+ * exactly as parts_minmax does.
+ */
+static inline bool minmax_fast_pick_b(uint64_t mag_a, uint64_t mag_b,
+                                      bool sign_a, bool sign_b, int flags)
+{
+    int cmp = mag_a < mag_b ? -1 : mag_a != mag_b;
+
+    if (!(flags & minmax_ismag) || cmp == 0) {
+        if (sign_a != sign_b) {
+            cmp = sign_a ? -1 : 1;
+        } else if (sign_a) {
+            cmp = -cmp;
+        }
+    }
+    if (flags & minmax_ismin) {
+        cmp = -cmp;
+    }
+    return cmp < 0;
+}
+
 static float32 float32_minmax(float32 a, float32 b, float_status *s, int flags)
 {
     FloatParts64 pa, pb, *pr;
 
+    if (likely(!float32_is_any_nan(a) && !float32_is_any_nan(b) &&
+               !float32_is_denormal(a) && !float32_is_denormal(b))) {
+        return minmax_fast_pick_b(float32_val(a) & INT32_MAX,
+                                  float32_val(b) & INT32_MAX,
+                                  float32_is_neg(a), float32_is_neg(b),
+                                  flags) ? b : a;
+    }
+
     float32_unpack_canonical(&pa, a, s);
     float32_unpack_canonical(&pb, b, s);
     pr = parts_minmax(&pa, &pb, s, flags);
@@ -4294,6 +4354,14 @@ static float64 float64_minmax(float64 a, float64 b, float_status *s, int flags)
 {
     FloatParts64 pa, pb, *pr;
 
+    if (likely(!float64_is_any_nan(a) && !float64_is_any_nan(b) &&
+               !float64_is_denormal(a) && !float64_is_denormal(b))) {
+        return minmax_fast_pick_b(float64_val(a) & INT64_MAX,
+                                  float64_val(b) & INT64_MAX,
+                                  float64_is_neg(a), float64_is_neg(b),
+                                  flags) ? b : a;
+    }
+
     float64_unpack_canonical(&pa, a, s);
     float64_unpack_canonical(&pb, b, s);
     pr = parts_minmax(&pa, &pb, s, flags);
@@ -235,6 +235,7 @@ struct AioContext {
 
     /* AIO engine parameters */
     int64_t aio_max_batch;  /* maximum number of requests in a batch */
+    int64_t aio_sqpoll_idle; /* io_uring SQPOLL idle time in ms, 0 = off */
 
     /*
      * List of handlers participating in userspace polling.  Protected by
@@ -715,9 +716,11 @@ void aio_context_set_poll_params(AioContext *ctx, int64_t max_ns,
  * @ctx: the aio context
  * @max_batch: maximum number of requests in a batch, 0 means that the
  *             engine will use its default
+ * @sqpoll_idle: idle time in milliseconds of the io_uring submission queue
+ *               polling thread, 0 means that no polling thread is used
  */
 void aio_context_set_aio_params(AioContext *ctx, int64_t max_batch,
-                                Error **errp);
+                                int64_t sqpoll_idle, Error **errp);
 
 /**
  * aio_context_set_thread_pool_params:
@@ -68,14 +68,21 @@ void laio_attach_aio_context(LinuxAioState *s, AioContext *new_context);
 /* io_uring.c - Linux io_uring implementation */
 #ifdef CONFIG_LINUX_IO_URING
 typedef struct LuringState LuringState;
-LuringState *luring_init(Error **errp);
+LuringState *luring_init(unsigned int sqpoll_idle, Error **errp);
 void luring_cleanup(LuringState *s);
 
-/* luring_co_submit: submit I/O requests in the thread's current AioContext. */
-int coroutine_fn luring_co_submit(BlockDriverState *bs, int fd, uint64_t offset,
-                                  QEMUIOVector *qiov, int type);
+/*
+ * luring_co_submit: submit I/O requests in the thread's current AioContext.
+ * @fixed_file is the slot returned by luring_register_fd() for @fd in the
+ * io_uring of the current AioContext, or -1.
+ */
+int coroutine_fn luring_co_submit(BlockDriverState *bs, int fd, int fixed_file,
+                                  uint64_t offset, QEMUIOVector *qiov,
+                                  int type);
 void luring_detach_aio_context(LuringState *s, AioContext *old_context);
 void luring_attach_aio_context(LuringState *s, AioContext *new_context);
+int luring_register_fd(LuringState *s, int fd);
+void luring_unregister_fd(LuringState *s, int slot);
 #endif
 
 #ifdef _WIN32
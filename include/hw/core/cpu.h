@@ -308,6 +308,9 @@ typedef struct CPUTLBCommon {
     size_t full_flush_count;
     size_t part_flush_count;
     size_t elide_flush_count;
+    /* Main tlb misses that were, or were not, satisfied by the victim TLB. */
+    size_t victim_hit_count;
+    size_t victim_miss_count;
 } CPUTLBCommon;
 
 /*
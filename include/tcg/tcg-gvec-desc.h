@@ -63,4 +63,11 @@ static inline int32_t simd_data(uint32_t desc)
     return sextract32(desc, SIMD_DATA_SHIFT, SIMD_DATA_BITS);
 }
 
+/*
+ * For testing: switch the out-of-line helpers to the next slower
+ * implementation.  Returns false, having restored the default selection,
+ * once the generic loops were already in use.
+ */
+bool test_gvec_next_accel(void);
+
 #endif
@@ -11,6 +11,7 @@
  */
 
 #include "qemu/osdep.h"
+#include "qemu/host-utils.h"
 #include "qemu/stats64.h"
 #include "qemu-file.h"
 #include "trace.h"
@@ -68,3 +69,15 @@ uint64_t migration_transferred_bytes(void)
     trace_migration_transferred_bytes(qemu_file, multifd, rdma);
     return qemu_file + multifd + rdma;
 }
+
+void migration_profile_end(MigrationPhase phase, int64_t start)
+{
+    MigrationPhaseStats *ps = &mig_stats.phase[phase];
+    uint64_t ns = MAX(qemu_clock_get_ns(QEMU_CLOCK_REALTIME) - start, 0);
+    int bucket = 64 - clz64(ns / SCALE_US);
+
+    stat64_add(&ps->count, 1);
+    stat64_add(&ps->total_ns, ns);
+    stat64_max(&ps->max_ns, ns);
+    stat64_add(&ps->histogram[MIN(bucket, MIGRATION_PROFILE_BUCKETS - 1)], 1);
+}
@@ -14,6 +14,8 @@
 #define QEMU_MIGRATION_STATS_H
 
 #include "qemu/stats64.h"
+#include "qemu/timer.h"
+#include "qapi/qapi-types-migration.h"
 
 /*
  * Amount of time to allocate to each "chunk" of bandwidth-throttled
@@ -27,6 +29,19 @@
  */
 #define RATE_LIMIT_DISABLED 0
 
+/*
+ * Number of duration buckets in each phase profile; see
+ * MigrationPhaseProfile in qapi/migration.json.
+ */
+#define MIGRATION_PROFILE_BUCKETS 16
+
+typedef struct {
+    Stat64 count;
+    Stat64 total_ns;
+    Stat64 max_ns;
+    Stat64 histogram[MIGRATION_PROFILE_BUCKETS];
+} MigrationPhaseStats;
+
 /*
  * These are the ram migration statistic counters.  It is loosely
  * based on MigrationStats.  We change to Stat64 any counter that
@@ -101,6 +116,10 @@ typedef struct {
      * Number of pages transferred that were full of zeros.
      */
     Stat64 zero_pages;
+    /*
+     * Duration of the phases of RAM migration.
+     */
+    MigrationPhaseStats phase[MIGRATION_PHASE__MAX];
 } MigrationAtomicStats;
 
 extern MigrationAtomicStats mig_stats;
@@ -136,4 +155,22 @@ void migration_rate_set(uint64_t new_rate);
  * channel, multifd, qemu_file, rdma, ....
  */
 uint64_t migration_transferred_bytes(void);
+
+/**
+ * migration_profile_start: Start timing a migration phase.
+ *
+ * Returns a timestamp to be passed to migration_profile_end().
+ */
+static inline int64_t migration_profile_start(void)
+{
+    return qemu_clock_get_ns(QEMU_CLOCK_REALTIME);
+}
+
+/**
+ * migration_profile_end: Account one run of a migration phase.
+ *
+ * @phase: the phase that was run
+ * @start: the value returned by migration_profile_start()
+ */
+void migration_profile_end(MigrationPhase phase, int64_t start);
 #endif
@@ -1203,6 +1203,29 @@ static void fill_source_migration_info(MigrationInfo *info)
     }
 }
 
+MigrationPhaseProfileList *qmp_query_migrate_profile(Error **errp)
+{
+    MigrationPhaseProfileList *head = NULL;
+    int phase, i;
+
+    for (phase = MIGRATION_PHASE__MAX - 1; phase >= 0; phase--) {
+        MigrationPhaseStats *ps = &mig_stats.phase[phase];
+        MigrationPhaseProfile *value = g_new0(MigrationPhaseProfile, 1);
+
+        value->phase = phase;
+        value->count = stat64_get(&ps->count);
+        value->total_ns = stat64_get(&ps->total_ns);
+        value->max_ns = stat64_get(&ps->max_ns);
+        for (i = MIGRATION_PROFILE_BUCKETS - 1; i >= 0; i--) {
+            QAPI_LIST_PREPEND(value->histogram,
+                              stat64_get(&ps->histogram[i]));
+        }
+        QAPI_LIST_PREPEND(head, value);
+    }
+
+    return head;
+}
+
 static void fill_destination_migration_info(MigrationInfo *info)
 {
     MigrationIncomingState *mis = migration_incoming_get_current();
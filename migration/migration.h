@@ -445,6 +445,15 @@ struct MigrationState {
      * Default value is false. (since 8.1)
      */
     bool multifd_flush_after_each_section;
+    /*
+     * Detect zero pages in the multifd send threads and send them as a
+     * list of offsets in the packet header, instead of checking every
+     * page in the migration thread.  QEMU 8.2 and older ignore the zero
+     * page list and would leave stale data in those pages, so this is
+     * off by default and must only be enabled when both sides support it.
+     * Default value is false. (since 9.0)
+     */
+    bool multifd_zero_page;
     /*
      * This decides the size of guest memory chunk that will be used
      * to track dirty bitmap clearing.  The size of memory chunk will
@@ -0,0 +1,264 @@
+/*
+ * Multifd lz4 compression implementation
+ *
+ * This work is licensed under the terms of the GNU GPL, version 2 or later.
+ * See the COPYING file in the top-level directory.
+ */
+
+#include "qemu/osdep.h"
+#include <lz4.h>
+#include "qemu/bswap.h"
+#include "qemu/rcu.h"
+#include "exec/ramblock.h"
+#include "exec/target_page.h"
+#include "qapi/error.h"
+#include "migration.h"
+#include "multifd.h"
+
+/*
+ * Each page is compressed on its own.  The packet data starts with one
+ * big endian uint32_t per page holding the size of its compressed data,
+ * followed by the data of each page.  A size equal to the page size
+ * means that the page is sent uncompressed.
+ *
+ * If a packet compresses to more than 7/8 of its original size, the
+ * channel stops trying to compress for the next LZ4_SKIP_PACKETS
+ * packets and sends the pages raw.
+ */
+#define LZ4_SKIP_PACKETS 16
+
+struct lz4_data {
+    /* compressed buffer */
+    uint8_t *zbuff;
+    /* size of compressed buffer */
+    uint32_t zbuff_len;
+    /* packets left to send without trying to compress */
+    uint32_t skip;
+};
+
+/* Multifd lz4 compression */
+
+/**
+ * lz4_send_setup: setup send side
+ *
+ * Allocate the buffer for the compressed pages.
+ *
+ * Returns 0 for success or -1 for error
+ *
+ * @p: Params for the channel that we are using
+ * @errp: pointer to an error
+ */
+static int lz4_send_setup(MultiFDSendParams *p, Error **errp)
+{
+    struct lz4_data *z = g_new0(struct lz4_data, 1);
+
+    /* Raw pages are never larger than the page itself */
+    z->zbuff_len = p->page_count * (sizeof(uint32_t) + p->page_size);
+    z->zbuff = g_try_malloc(z->zbuff_len);
+    if (!z->zbuff) {
+        g_free(z);
+        error_setg(errp, "multifd %u: out of memory for zbuff", p->id);
+        return -1;
+    }
+    p->data = z;
+    return 0;
+}
+
+/**
+ * lz4_send_cleanup: cleanup send side
+ *
+ * Return memory.
+ *
+ * @p: Params for the channel that we are using
+ * @errp: pointer to an error
+ */
+static void lz4_send_cleanup(MultiFDSendParams *p, Error **errp)
+{
+    struct lz4_data *z = p->data;
+
+    g_free(z->zbuff);
+    z->zbuff = NULL;
+    g_free(p->data);
+    p->data = NULL;
+}
+
+/**
+ * lz4_send_prepare: prepare date to be able to send
+ *
+ * Create a buffer with the size table and all the pages that we are
+ * going to send, compressed where that pays off.
+ *
+ * Returns 0 for success or -1 for error
+ *
+ * @p: Params for the channel that we are using
+ * @errp: pointer to an error
+ */
+static int lz4_send_prepare(MultiFDSendParams *p, Error **errp)
+{
+    struct lz4_data *z = p->data;
+    uint32_t *sizes = (uint32_t *)z->zbuff;
+    uint32_t header_len = p->normal_num * sizeof(uint32_t);
+    uint32_t raw_size = p->normal_num * p->page_size;
+    uint32_t pos = header_len;
+    bool compress = z->skip == 0;
+    uint32_t i;
+
+    if (!compress) {
+        z->skip--;
+    }
+
+    for (i = 0; i < p->normal_num; i++) {
+        const char *src = (const char *)p->pages->block->host + p->normal[i];
+        char *dst = (char *)z->zbuff + pos;
+        int ret = 0;
+
+        if (compress) {
+            /* Anything that does not fit in less than a page is sent raw */
+            ret = LZ4_compress_default(src, dst, p->page_size,
+                                       p->page_size - 1);
+        }
+        if (ret <= 0) {
+            memcpy(dst, src, p->page_size);
+            ret = p->page_size;
+        }
+        sizes[i] = cpu_to_be32(ret);
+        pos += ret;
+    }
+
+    if (compress && pos - header_len > raw_size / 8 * 7) {
+        z->skip = LZ4_SKIP_PACKETS;
+    }
+
+    p->iov[p->iovs_num].iov_base = z->zbuff;
+    p->iov[p->iovs_num].iov_len = pos;
+    p->iovs_num++;
+    p->next_packet_size = pos;
+    p->flags |= MULTIFD_FLAG_LZ4;
+
+    return 0;
+}
+
+/**
+ * lz4_recv_setup: setup receive side
+ *
+ * Allocate the buffer for the compressed pages.
+ *
+ * Returns 0 for success or -1 for error
+ *
+ * @p: Params for the channel that we are using
+ * @errp: pointer to an error
+ */
+static int lz4_recv_setup(MultiFDRecvParams *p, Error **errp)
+{
+    struct lz4_data *z = g_new0(struct lz4_data, 1);
+
+    z->zbuff_len = p->page_count * (sizeof(uint32_t) + p->page_size);
+    z->zbuff = g_try_malloc(z->zbuff_len);
+    if (!z->zbuff) {
+        g_free(z);
+        error_setg(errp, "multifd %u: out of memory for zbuff", p->id);
+        return -1;
+    }
+    p->data = z;
+    return 0;
+}
+
+/**
+ * lz4_recv_cleanup: cleanup receive side
+ *
+ * Return memory.
+ *
+ * @p: Params for the channel that we are using
+ */
+static void lz4_recv_cleanup(MultiFDRecvParams *p)
+{
+    struct lz4_data *z = p->data;
+
+    g_free(z->zbuff);
+    z->zbuff = NULL;
+    g_free(p->data);
+    p->data = NULL;
+}
+
+/**
+ * lz4_recv_pages: read the data from the channel into actual pages
+ *
+ * Read the compressed buffer, and uncompress it into the actual
+ * pages.
+ *
+ * Returns 0 for success or -1 for error
+ *
+ * @p: Params for the channel that we are using
+ * @errp: pointer to an error
+ */
+static int lz4_recv_pages(MultiFDRecvParams *p, Error **errp)
+{
+    uint32_t in_size = p->next_packet_size;
+    uint32_t flags = p->flags & MULTIFD_FLAG_COMPRESSION_MASK;
+    struct lz4_data *z = p->data;
+    uint32_t *sizes = (uint32_t *)z->zbuff;
+    uint32_t pos = p->normal_num * sizeof(uint32_t);
+    uint32_t i;
+    int ret;
+
+    if (flags != MULTIFD_FLAG_LZ4) {
+        error_setg(errp, "multifd %u: flags received %x flags expected %x",
+                   p->id, flags, MULTIFD_FLAG_LZ4);
+        return -1;
+    }
+    if (in_size > z->zbuff_len || in_size < pos) {
+        error_setg(errp, "multifd %u: packet size received %u "
+                   "for %u pages", p->id, in_size, p->normal_num);
+        return -1;
+    }
+
+    ret = qio_channel_read_all(p->c, (void *)z->zbuff, in_size, errp);
+    if (ret != 0) {
+        return ret;
+    }
+
+    for (i = 0; i < p->normal_num; i++) {
+        uint32_t size = be32_to_cpu(sizes[i]);
+        const char *src = (const char *)z->zbuff + pos;
+        char *dst = (char *)p->host + p->normal[i];
+
+        if (size > p->page_size || size > in_size - pos) {
+            error_setg(errp, "multifd %u: page %u compressed size %u "
+                       "is too large", p->id, i, size);
+            return -1;
+        }
+        if (size == p->page_size) {
+            memcpy(dst, src, p->page_size);
+        } else {
+            ret = LZ4_decompress_safe(src, dst, size, p->page_size);
+            if (ret != p->page_size) {
+                error_setg(errp, "multifd %u: LZ4_decompress_safe "
+                           "returned %d for page %u", p->id, ret, i);
+                return -1;
+            }
+        }
+        pos += size;
+    }
+    if (pos != in_size) {
+        error_setg(errp, "multifd %u: packet size received %u size expected %u",
+                   p->id, in_size, pos);
+        return -1;
+    }
+    return 0;
+}
+
+static MultiFDMethods multifd_lz4_ops = {
+    .send_setup = lz4_send_setup,
+    .send_cleanup = lz4_send_cleanup,
+    .send_prepare = lz4_send_prepare,
+    .recv_setup = lz4_recv_setup,
+    .recv_cleanup = lz4_recv_cleanup,
+    .recv_pages = lz4_recv_pages
+};
+
+static void multifd_lz4_register(void)
+{
+    multifd_register_ops(MULTIFD_COMPRESSION_LZ4, &multifd_lz4_ops);
+}
+
+migration_init(multifd_lz4_register);
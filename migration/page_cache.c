@@ -1,6 +1,6 @@
 /*
  * Page cache for QEMU
- * The cache is base on a hash of the page address
+ * The cache is set associative, indexed by a hash of the page address
  *
  * Copyright 2012 Red Hat, Inc. and/or its affiliates
  *
@@ -23,6 +23,12 @@
 /* the page in cache will not be replaced in two cycles */
 #define CACHED_PAGE_LIFETIME 2
 
+/*
+ * Number of pages per set.  Within a set, a new page replaces the least
+ * recently used one, i.e. the one with the oldest it_age.
+ */
+#define CACHE_WAYS 4
+
 typedef struct CacheItem CacheItem;
 
 struct CacheItem {
@@ -36,6 +42,7 @@ struct PageCache {
     size_t page_size;
     size_t max_num_items;
     size_t num_items;
+    size_t num_ways;
 };
 
 PageCache *cache_init(uint64_t new_size, size_t page_size, Error **errp)
@@ -66,6 +73,7 @@ PageCache *cache_init(uint64_t new_size, size_t page_size, Error **errp)
     cache->page_size = page_size;
     cache->num_items = 0;
     cache->max_num_items = num_pages;
+    cache->num_ways = MIN(num_pages, CACHE_WAYS);
 
     trace_migration_pagecache_init(cache->max_num_items);
 
@@ -103,28 +111,65 @@ void cache_fini(PageCache *cache)
     g_free(cache);
 }
 
-static size_t cache_get_cache_pos(const PageCache *cache,
-                                  uint64_t address)
+/* Return the first item of the set that may hold @address */
+static CacheItem *cache_get_set(const PageCache *cache, uint64_t address)
 {
+    size_t num_sets, pos;
+
+    g_assert(cache);
+    g_assert(cache->page_cache);
     g_assert(cache->max_num_items);
-    return (address / cache->page_size) & (cache->max_num_items - 1);
+
+    num_sets = cache->max_num_items / cache->num_ways;
+    pos = (address / cache->page_size) & (num_sets - 1);
+
+    return &cache->page_cache[pos * cache->num_ways];
 }
 
 static CacheItem *cache_get_by_addr(const PageCache *cache, uint64_t addr)
 {
-    size_t pos;
+    CacheItem *set = cache_get_set(cache, addr);
+    size_t i;
 
-    g_assert(cache);
-    g_assert(cache->page_cache);
+    for (i = 0; i < cache->num_ways; i++) {
+        if (set[i].it_addr == addr) {
+            return &set[i];
+        }
+    }
+    return NULL;
+}
+
+/*
+ * Return the item to use for @addr: the one already holding it, else
+ * a free one, else the least recently used one in the set.
+ */
+static CacheItem *cache_get_victim(const PageCache *cache, uint64_t addr)
+{
+    CacheItem *set = cache_get_set(cache, addr);
+    CacheItem *victim = &set[0];
+    size_t i;
 
-    pos = cache_get_cache_pos(cache, addr);
+    for (i = 0; i < cache->num_ways; i++) {
+        CacheItem *it = &set[i];
 
-    return &cache->page_cache[pos];
+        if (it->it_addr == addr) {
+            return it;
+        }
+        if (!victim->it_data) {
+            continue;
+        }
+        if (!it->it_data || it->it_age < victim->it_age) {
+            victim = it;
+        }
+    }
+    return victim;
 }
 
 uint8_t *get_cached_data(const PageCache *cache, uint64_t addr)
 {
-    return cache_get_by_addr(cache, addr)->it_data;
+    CacheItem *it = cache_get_by_addr(cache, addr);
+
+    return it ? it->it_data : NULL;
 }
 
 bool cache_is_cached(const PageCache *cache, uint64_t addr,
@@ -134,7 +179,7 @@ bool cache_is_cached(const PageCache *cache, uint64_t addr,
 
     it = cache_get_by_addr(cache, addr);
 
-    if (it->it_addr == addr) {
+    if (it) {
         /* update the it_age when the cache hit */
         it->it_age = current_age;
         return true;
@@ -149,11 +194,11 @@ int cache_insert(PageCache *cache, uint64_t addr, const uint8_t *pdata,
     CacheItem *it;
 
     /* actual update of entry */
-    it = cache_get_by_addr(cache, addr);
+    it = cache_get_victim(cache, addr);
 
     if (it->it_data && it->it_addr != addr &&
         it->it_age + CACHED_PAGE_LIFETIME > current_age) {
-        /* the cache page is fresh, don't replace it */
+        /* even the oldest page in the set is fresh, don't replace it */
         return -1;
     }
     /* allocate page */
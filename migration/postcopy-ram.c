@@ -18,6 +18,7 @@
 
 #include "qemu/osdep.h"
 #include "qemu/madvise.h"
+#include "qemu/units.h"
 #include "exec/target_page.h"
 #include "migration.h"
 #include "qemu-file.h"
@@ -808,6 +809,74 @@ int postcopy_request_shared_page(struct PostCopyFD *pcfd, RAMBlock *rb,
     return 0;
 }
 
+/*
+ * Sequential fault detection for the fault thread.  When the guest
+ * faults on consecutive host pages of a RAMBlock, ask the source for the
+ * next few pages too, so that a linear scan does not pay a round trip
+ * for every page.  A fault that lands inside the window prefetched last
+ * time continues the run, since the pages before it no longer fault.
+ *
+ * The window is at most POSTCOPY_PREFETCH_PAGES host pages and at most
+ * POSTCOPY_PREFETCH_BYTES, so that prefetching does not delay real faults
+ * behind large requests.  RAMBlocks with host pages larger than the byte
+ * budget, such as 1 GiB hugetlbfs, are never prefetched.
+ */
+#define POSTCOPY_PREFETCH_RUN   2
+#define POSTCOPY_PREFETCH_PAGES 4
+#define POSTCOPY_PREFETCH_BYTES (2 * MiB)
+
+typedef struct PostcopyPrefetch {
+    RAMBlock *rb;
+    /* offset of the last faulting host page */
+    ram_addr_t last;
+    /* end of the pages requested after the last fault */
+    ram_addr_t limit;
+    /* number of consecutive sequential faults */
+    unsigned int run;
+} PostcopyPrefetch;
+
+static void postcopy_prefetch_pages(MigrationIncomingState *mis,
+                                    PostcopyPrefetch *pf,
+                                    RAMBlock *rb, ram_addr_t rb_offset)
+{
+    size_t pagesize = qemu_ram_pagesize(rb);
+    unsigned int pages = MIN(POSTCOPY_PREFETCH_PAGES,
+                             POSTCOPY_PREFETCH_BYTES / pagesize);
+    ram_addr_t offset;
+    unsigned int i;
+
+    if (pf->rb == rb && rb_offset > pf->last && rb_offset <= pf->limit) {
+        pf->run++;
+    } else {
+        pf->run = 0;
+    }
+    pf->rb = rb;
+    pf->last = rb_offset;
+    pf->limit = rb_offset + pagesize;
+
+    if (pf->run < POSTCOPY_PREFETCH_RUN) {
+        return;
+    }
+
+    offset = rb_offset + pagesize;
+    for (i = 0; i < pages; i++, offset += pagesize) {
+        if (offset >= rb->used_length) {
+            break;
+        }
+        pf->limit = offset + pagesize;
+        if (ramblock_recv_bitmap_test_byte_offset(rb, offset) ||
+            ramblock_page_is_discarded(rb, offset)) {
+            continue;
+        }
+        trace_postcopy_prefetch_page(qemu_ram_get_idstr(rb), offset);
+        /* A failure here is noticed again by the next real fault */
+        if (migrate_send_rp_req_pages(mis, rb, offset,
+                                      (uintptr_t)rb->host + offset)) {
+            break;
+        }
+    }
+}
+
 static int get_mem_fault_cpu_index(uint32_t pid)
 {
     CPUState *cpu_iter;
@@ -971,6 +1040,7 @@ static void *postcopy_ram_fault_thread(void *opaque)
     int ret;
     size_t index;
     RAMBlock *rb = NULL;
+    PostcopyPrefetch prefetch = {};
 
     trace_postcopy_ram_fault_thread_entry();
     rcu_register_thread();
@@ -1095,6 +1165,7 @@ retry:
                 postcopy_pause_fault_thread(mis);
                 goto retry;
             }
+            postcopy_prefetch_pages(mis, &prefetch, rb, rb_offset);
         }
 
         /* Now handle any requests from external processes on shared memory */
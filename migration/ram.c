@@ -331,6 +331,9 @@ struct RAMSrcPageRequest {
     QSIMPLEQ_ENTRY(RAMSrcPageRequest) next_req;
 };
 
+/* Time one in this many calls of ram_find_and_save_block() */
+#define FIND_AND_SAVE_PROFILE_INTERVAL 64
+
 /* State of RAM for migration */
 struct RAMState {
     /*
@@ -374,6 +377,8 @@ struct RAMState {
     uint64_t target_page_count;
     /* number of dirty bits in the bitmap */
     uint64_t migration_dirty_pages;
+    /* number of ram_find_and_save_block() calls, for sampling its profile */
+    uint64_t find_and_save_count;
     /*
      * Protects:
      * - dirty/clear bitmap
@@ -1035,6 +1040,7 @@ static void migration_bitmap_sync(RAMState *rs, bool last_stage)
 {
     RAMBlock *block;
     int64_t end_time;
+    int64_t profile_start = migration_profile_start();
 
     stat64_add(&mig_stats.dirty_sync_count, 1);
 
@@ -1076,6 +1082,7 @@ static void migration_bitmap_sync(RAMState *rs, bool last_stage)
         uint64_t generation = stat64_get(&mig_stats.dirty_sync_count);
         qapi_event_send_migration_pass(generation);
     }
+    migration_profile_end(MIGRATION_PHASE_BITMAP_SYNC, profile_start);
 }
 
 static void migration_bitmap_sync_precopy(RAMState *rs, bool last_stage)
@@ -1256,7 +1263,7 @@ static int ram_save_multifd_page(QEMUFile *file, RAMBlock *block,
     if (multifd_queue_page(file, block, offset) < 0) {
         return -1;
     }
-    stat64_add(&mig_stats.normal_pages, 1);
+    /* normal and zero pages are accounted by the multifd send thread */
 
     return 1;
 }
@@ -2046,6 +2053,7 @@ static int ram_save_target_page_legacy(RAMState *rs, PageSearchStatus *pss)
 {
     RAMBlock *block = pss->block;
     ram_addr_t offset = ((ram_addr_t)pss->page) << TARGET_PAGE_BITS;
+    bool use_multifd;
     int res;
 
     if (control_save_page(pss, offset, &res)) {
@@ -2056,17 +2064,21 @@ static int ram_save_target_page_legacy(RAMState *rs, PageSearchStatus *pss)
         return 1;
     }
 
-    if (save_zero_page(rs, pss, offset)) {
-        return 1;
-    }
-
     /*
      * Do not use multifd in postcopy as one whole host page should be
      * placed.  Meanwhile postcopy requires atomic update of pages, so even
      * if host page size == guest page size the dest guest during run may
      * still see partially copied pages which is data corruption.
      */
-    if (migrate_multifd() && !migration_in_postcopy()) {
+    use_multifd = migrate_multifd() && !migration_in_postcopy();
+
+    /* With multifd, zero pages are detected by the send threads */
+    if ((!use_multifd || !migrate_multifd_zero_page()) &&
+        save_zero_page(rs, pss, offset)) {
+        return 1;
+    }
+
+    if (use_multifd) {
         return ram_save_multifd_page(pss->pss_channel, block, offset);
     }
 
@@ -2277,12 +2289,20 @@ static int ram_find_and_save_block(RAMState *rs)
 {
     PageSearchStatus *pss = &rs->pss[RAM_CHANNEL_PRECOPY];
     int pages = 0;
+    bool profile;
+    int64_t profile_start = 0;
 
     /* No dirty page as there is zero RAM */
     if (!rs->ram_bytes_total) {
         return pages;
     }
 
+    /* This runs for every host page, only time a sample of the calls */
+    profile = rs->find_and_save_count++ % FIND_AND_SAVE_PROFILE_INTERVAL == 0;
+    if (profile) {
+        profile_start = migration_profile_start();
+    }
+
     /*
      * Always keep last_seen_block/last_page valid during this procedure,
      * because find_dirty_block() relies on these values (e.g., we compare
@@ -2321,6 +2341,9 @@ static int ram_find_and_save_block(RAMState *rs)
     rs->last_seen_block = pss->block;
     rs->last_page = pss->page;
 
+    if (profile) {
+        migration_profile_end(MIGRATION_PHASE_FIND_AND_SAVE, profile_start);
+    }
     return pages;
 }
 
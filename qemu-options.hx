@@ -5796,7 +5796,7 @@ SRST
 
             CN=laptop.example.com,O=Example Home,L=London,ST=London,C=GB
 
-    ``-object iothread,id=id,poll-max-ns=poll-max-ns,poll-grow=poll-grow,poll-shrink=poll-shrink,aio-max-batch=aio-max-batch``
+    ``-object iothread,id=id,poll-max-ns=poll-max-ns,poll-grow=poll-grow,poll-shrink=poll-shrink,aio-max-batch=aio-max-batch,aio-sqpoll-idle=aio-sqpoll-idle``
         Creates a dedicated event loop thread that devices can be
         assigned to. This is known as an IOThread. By default device
         emulation happens in vCPU threads or the main event loop thread.
@@ -5836,6 +5836,13 @@ SRST
         in a batch for the AIO engine, 0 means that the engine will use
         its default.
 
+        The ``aio-sqpoll-idle`` parameter makes ``aio=io_uring`` use a
+        kernel thread that polls the io_uring submission queue, so that
+        submitting requests does not need a system call. The thread
+        sleeps after ``aio-sqpoll-idle`` milliseconds without requests.
+        It is disabled by setting this value to 0, and only affects
+        io_uring instances that are created after it is set.
+
         The IOThread parameters can be modified at run-time using the
         ``qom-set`` command (where ``iothread1`` is the IOThread's
         ``id``):
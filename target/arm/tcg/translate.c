@@ -341,8 +341,20 @@ static void store_sp_checked(DisasContext *s, TCGv_i32 var)
 #define gen_sxtb(var) tcg_gen_ext8s_i32(var, var)
 #define gen_sxth(var) tcg_gen_ext16s_i32(var, var)
 
-#define gen_sxtb16(var) gen_helper_sxtb16(var, var)
-#define gen_uxtb16(var) gen_helper_uxtb16(var, var)
+/* Extend bytes 0 and 2 into the two halfwords.  */
+static void gen_sxtb16(TCGv_i32 dest, TCGv_i32 src)
+{
+    TCGv_i32 tmp = tcg_temp_new_i32();
+
+    tcg_gen_sextract_i32(tmp, src, 16, 8);
+    tcg_gen_ext8s_i32(dest, src);
+    tcg_gen_deposit_i32(dest, dest, tmp, 16, 16);
+}
+
+static void gen_uxtb16(TCGv_i32 dest, TCGv_i32 src)
+{
+    tcg_gen_andi_i32(dest, src, 0x00ff00ff);
+}
 
 void gen_set_cpsr(TCGv_i32 var, uint32_t mask)
 {
@@ -7506,7 +7518,7 @@ static bool trans_SXTAB16(DisasContext *s, arg_rrr_rot *a)
     if (s->thumb && !arm_dc_feature(s, ARM_FEATURE_THUMB_DSP)) {
         return false;
     }
-    return op_xta(s, a, gen_helper_sxtb16, gen_add16);
+    return op_xta(s, a, gen_sxtb16, gen_add16);
 }
 
 static bool trans_UXTAB(DisasContext *s, arg_rrr_rot *a)
@@ -7524,7 +7536,7 @@ static bool trans_UXTAB16(DisasContext *s, arg_rrr_rot *a)
     if (s->thumb && !arm_dc_feature(s, ARM_FEATURE_THUMB_DSP)) {
         return false;
     }
-    return op_xta(s, a, gen_helper_uxtb16, gen_add16);
+    return op_xta(s, a, gen_uxtb16, gen_add16);
 }
 
 static bool trans_SEL(DisasContext *s, arg_rrr *a)
@@ -45,6 +45,12 @@ typedef struct MemCopyInfo {
     TCGType type;
 } MemCopyInfo;
 
+typedef struct MemStoreInfo {
+    IntervalTreeNode itree;
+    QSIMPLEQ_ENTRY (MemStoreInfo) next;
+    TCGOp *op;
+} MemStoreInfo;
+
 typedef struct TempOptInfo {
     bool is_const;
     TCGTemp *prev_copy;
@@ -63,6 +69,10 @@ typedef struct OptContext {
     IntervalTreeRoot mem_copy;
     QSIMPLEQ_HEAD(, MemCopyInfo) mem_free;
 
+    /* Stores to env not yet read, candidates for dead store elimination. */
+    IntervalTreeRoot mem_store;
+    QSIMPLEQ_HEAD(, MemStoreInfo) mem_store_free;
+
     /* In flight values from optimization. */
     uint64_t a_mask;  /* mask bit is 0 iff value identical to first input */
     uint64_t z_mask;  /* mask bit is 0 iff value bit is 0 */
@@ -210,6 +220,89 @@ static void remove_mem_copy_all(OptContext *ctx)
     tcg_debug_assert(interval_tree_is_empty(&ctx->mem_copy));
 }
 
+static MemStoreInfo *mem_store_first(OptContext *ctx, intptr_t s, intptr_t l)
+{
+    IntervalTreeNode *r = interval_tree_iter_first(&ctx->mem_store, s, l);
+    return r ? container_of(r, MemStoreInfo, itree) : NULL;
+}
+
+static MemStoreInfo *mem_store_next(MemStoreInfo *ms, intptr_t s, intptr_t l)
+{
+    IntervalTreeNode *r = interval_tree_iter_next(&ms->itree, s, l);
+    return r ? container_of(r, MemStoreInfo, itree) : NULL;
+}
+
+static void remove_mem_store(OptContext *ctx, MemStoreInfo *ms)
+{
+    interval_tree_remove(&ms->itree, &ctx->mem_store);
+    QSIMPLEQ_INSERT_TAIL(&ctx->mem_store_free, ms, next);
+}
+
+/* The bytes [s, l] of env are read: stores to them are no longer dead. */
+static void remove_mem_store_in(OptContext *ctx, intptr_t s, intptr_t l)
+{
+    while (true) {
+        MemStoreInfo *ms = mem_store_first(ctx, s, l);
+        if (!ms) {
+            break;
+        }
+        remove_mem_store(ctx, ms);
+    }
+}
+
+static void remove_mem_store_all(OptContext *ctx)
+{
+    remove_mem_store_in(ctx, 0, -1);
+    tcg_debug_assert(interval_tree_is_empty(&ctx->mem_store));
+}
+
+/*
+ * Record that OP stores to the bytes [start, last] of env.
+ * Any pending store that is entirely overwritten by OP has not been
+ * read in between, and is therefore dead.
+ */
+static void record_mem_store(OptContext *ctx, TCGOp *op,
+                             intptr_t start, intptr_t last)
+{
+    MemStoreInfo *ms, *ms_next;
+
+    for (ms = mem_store_first(ctx, start, last); ms; ms = ms_next) {
+        ms_next = mem_store_next(ms, start, last);
+        if (ms->itree.start >= (uint64_t)start &&
+            ms->itree.last <= (uint64_t)last) {
+            tcg_op_remove(ctx->tcg, ms->op);
+            remove_mem_store(ctx, ms);
+        }
+    }
+
+    ms = QSIMPLEQ_FIRST(&ctx->mem_store_free);
+    if (ms) {
+        QSIMPLEQ_REMOVE_HEAD(&ctx->mem_store_free, next);
+    } else {
+        ms = tcg_malloc(sizeof(*ms));
+    }
+
+    memset(ms, 0, sizeof(*ms));
+    ms->itree.start = start;
+    ms->itree.last = last;
+    ms->op = op;
+    interval_tree_insert(&ms->itree, &ctx->mem_store);
+}
+
+/*
+ * OP loads LM1 + 1 bytes from args[1] + args[2].  If the base is not
+ * env, the load may alias any part of it.
+ */
+static void mem_store_read(OptContext *ctx, TCGOp *op, intptr_t lm1)
+{
+    if (op->args[1] == tcgv_ptr_arg(tcg_env)) {
+        intptr_t ofs = op->args[2];
+        remove_mem_store_in(ctx, ofs, ofs + lm1);
+    } else {
+        remove_mem_store_all(ctx);
+    }
+}
+
 static TCGTemp *find_better_copy(TCGTemp *ts)
 {
     TCGTemp *i, *ret;
@@ -815,6 +908,7 @@ static void finish_folding(OptContext *ctx, TCGOp *op)
      */
     if (def->flags & TCG_OPF_BB_END) {
         ctx->prev_mb = NULL;
+        remove_mem_store_all(ctx);
         if (!(def->flags & TCG_OPF_COND_BRANCH)) {
             memset(&ctx->temps_used, 0, sizeof(ctx->temps_used));
             remove_mem_copy_all(ctx);
@@ -1365,6 +1459,13 @@ static bool fold_call(OptContext *ctx, TCGOp *op)
         remove_mem_copy_all(ctx);
     }
 
+    /*
+     * The call flags only describe accesses to globals, while a helper
+     * may read any part of env through its arguments or while raising
+     * an exception.  Pending stores must all be performed.
+     */
+    remove_mem_store_all(ctx);
+
     /* Reset temp data for outputs. */
     for (i = 0; i < nb_oargs; i++) {
         reset_temp(ctx, op->args[i]);
@@ -1496,6 +1597,12 @@ static bool fold_dup(OptContext *ctx, TCGOp *op)
     return false;
 }
 
+static bool fold_dupm(OptContext *ctx, TCGOp *op)
+{
+    mem_store_read(ctx, op, (1 << TCGOP_VECE(op)) - 1);
+    return false;
+}
+
 static bool fold_dup2(OptContext *ctx, TCGOp *op)
 {
     if (arg_is_const(op->args[1]) && arg_is_const(op->args[2])) {
@@ -1921,6 +2028,9 @@ static bool fold_qemu_ld(OptContext *ctx, TCGOp *op)
 
     /* Opcodes that touch guest memory stop the mb optimization.  */
     ctx->prev_mb = NULL;
+
+    /* Guest memory access may fault, so env must be up to date. */
+    remove_mem_store_all(ctx);
     return false;
 }
 
@@ -1928,6 +2038,9 @@ static bool fold_qemu_st(OptContext *ctx, TCGOp *op)
 {
     /* Opcodes that touch guest memory stop the mb optimization.  */
     ctx->prev_mb = NULL;
+
+    /* Guest memory access may fault, so env must be up to date. */
+    remove_mem_store_all(ctx);
     return false;
 }
 
@@ -2205,32 +2318,41 @@ static bool fold_sub2(OptContext *ctx, TCGOp *op)
 
 static bool fold_tcg_ld(OptContext *ctx, TCGOp *op)
 {
+    intptr_t lm1;
+
     /* We can't do any folding with a load, but we can record bits. */
     switch (op->opc) {
     CASE_OP_32_64(ld8s):
         ctx->s_mask = MAKE_64BIT_MASK(8, 56);
+        lm1 = 0;
         break;
     CASE_OP_32_64(ld8u):
         ctx->z_mask = MAKE_64BIT_MASK(0, 8);
         ctx->s_mask = MAKE_64BIT_MASK(9, 55);
+        lm1 = 0;
         break;
     CASE_OP_32_64(ld16s):
         ctx->s_mask = MAKE_64BIT_MASK(16, 48);
+        lm1 = 1;
         break;
     CASE_OP_32_64(ld16u):
         ctx->z_mask = MAKE_64BIT_MASK(0, 16);
         ctx->s_mask = MAKE_64BIT_MASK(17, 47);
+        lm1 = 1;
         break;
     case INDEX_op_ld32s_i64:
         ctx->s_mask = MAKE_64BIT_MASK(32, 32);
+        lm1 = 3;
         break;
     case INDEX_op_ld32u_i64:
         ctx->z_mask = MAKE_64BIT_MASK(0, 32);
         ctx->s_mask = MAKE_64BIT_MASK(33, 31);
+        lm1 = 3;
         break;
     default:
         g_assert_not_reached();
     }
+    mem_store_read(ctx, op, lm1);
     return false;
 }
 
@@ -2241,6 +2363,7 @@ static bool fold_tcg_ld_memcopy(OptContext *ctx, TCGOp *op)
     TCGType type;
 
     if (op->args[1] != tcgv_ptr_arg(tcg_env)) {
+        remove_mem_store_all(ctx);
         return false;
     }
 
@@ -2252,6 +2375,8 @@ static bool fold_tcg_ld_memcopy(OptContext *ctx, TCGOp *op)
         return tcg_opt_gen_mov(ctx, op, temp_arg(dst), temp_arg(src));
     }
 
+    /* The load was not forwarded, so it reads memory. */
+    remove_mem_store_in(ctx, ofs, ofs + tcg_type_size(type) - 1);
     reset_ts(ctx, dst);
     record_mem_copy(ctx, type, dst, ofs, ofs + tcg_type_size(type) - 1);
     return true;
@@ -2288,6 +2413,7 @@ static bool fold_tcg_st(OptContext *ctx, TCGOp *op)
         g_assert_not_reached();
     }
     remove_mem_copy_in(ctx, ofs, ofs + lm1);
+    record_mem_store(ctx, op, ofs, ofs + lm1);
     return false;
 }
 
@@ -2321,6 +2447,7 @@ static bool fold_tcg_st_memcopy(OptContext *ctx, TCGOp *op)
     last = ofs + tcg_type_size(type) - 1;
     remove_mem_copy_in(ctx, ofs, last);
     record_mem_copy(ctx, type, src, ofs, last);
+    record_mem_store(ctx, op, ofs, last);
     return false;
 }
 
@@ -2348,6 +2475,7 @@ void tcg_optimize(TCGContext *s)
     OptContext ctx = { .tcg = s };
 
     QSIMPLEQ_INIT(&ctx.mem_free);
+    QSIMPLEQ_INIT(&ctx.mem_store_free);
 
     /* Array VALS has an element for each temp.
        If this temp holds a constant then its value is kept in VALS' element.
@@ -2439,6 +2567,9 @@ void tcg_optimize(TCGContext *s)
         case INDEX_op_dup2_vec:
             done = fold_dup2(&ctx, op);
             break;
+        case INDEX_op_dupm_vec:
+            done = fold_dupm(&ctx, op);
+            break;
         CASE_OP_32_64_VEC(eqv):
             done = fold_eqv(&ctx, op);
             break;
@@ -0,0 +1,92 @@
+/*
+ * Out-of-line gvec helper speed benchmark
+ *
+ * Each case is run once per implementation available on the host,
+ * starting with the one selected at startup and stepping down with
+ * test_gvec_next_accel() to the generic loops.
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+#include "qemu/osdep.h"
+#include "qemu/units.h"
+#include "exec/helper-proto-common.h"
+#include "tcg/tcg-gvec-desc.h"
+
+typedef void GVecHelper3(void *, void *, void *, uint32_t);
+
+typedef struct GVecBenchOpts {
+    const char *name;
+    GVecHelper3 *fn;
+    uint32_t size;
+} GVecBenchOpts;
+
+static void test_gvec_speed(const void *opaque)
+{
+    const GVecBenchOpts *opts = opaque;
+    const size_t total = 1 * GiB;
+    uint8_t *d, *a, *b;
+    uint32_t desc;
+    size_t remain;
+    int impl = 0;
+
+    /* oprsz == maxsz, encoded as simd_desc() does; it is not linked here. */
+    desc = deposit32(0, SIMD_MAXSZ_SHIFT, SIMD_MAXSZ_BITS, opts->size / 8 - 1);
+    desc = deposit32(desc, SIMD_OPRSZ_SHIFT, SIMD_OPRSZ_BITS, 2);
+    g_assert(simd_oprsz(desc) == opts->size);
+
+    d = g_new0(uint8_t, opts->size);
+    a = g_new(uint8_t, opts->size);
+    b = g_new(uint8_t, opts->size);
+    memset(a, g_test_rand_int(), opts->size);
+    memset(b, g_test_rand_int(), opts->size);
+
+    do {
+        g_test_timer_start();
+        for (remain = total; remain; remain -= opts->size) {
+            opts->fn(d, a, b, desc);
+        }
+        g_test_timer_elapsed();
+
+        g_test_message("%s: oprsz %u bytes, impl %d: %.2f MB/sec",
+                       opts->name, opts->size, impl,
+                       total / MiB / g_test_timer_last());
+        impl++;
+    } while (test_gvec_next_accel());
+
+    g_free(d);
+    g_free(a);
+    g_free(b);
+}
+
+int main(int argc, char **argv)
+{
+    static const uint32_t sizes[] = { 16, 64, 256, 2048 };
+    static const struct {
+        const char *name;
+        GVecHelper3 *fn;
+    } ops[] = {
+        { "add8", helper_gvec_add8 },
+        { "add64", helper_gvec_add64 },
+        { "sub32", helper_gvec_sub32 },
+        { "xor", helper_gvec_xor },
+        { "andc", helper_gvec_andc },
+    };
+    static GVecBenchOpts opts[ARRAY_SIZE(ops) * ARRAY_SIZE(sizes)];
+    char name[64];
+    int i, j, n = 0;
+
+    g_test_init(&argc, &argv, NULL);
+
+    for (i = 0; i < ARRAY_SIZE(ops); i++) {
+        for (j = 0; j < ARRAY_SIZE(sizes); j++, n++) {
+            opts[n] = (GVecBenchOpts) {
+                .name = ops[i].name, .fn = ops[i].fn, .size = sizes[j],
+            };
+            snprintf(name, sizeof(name), "/tcg/benchmark/gvec/%s/oprsz-%u",
+                     ops[i].name, sizes[j]);
+            g_test_add_data_func(name, &opts[n], test_gvec_speed);
+        }
+    }
+
+    return g_test_run();
+}
@@ -13,6 +13,7 @@
 #include "qemu/osdep.h"
 #include <math.h>
 #include <fenv.h>
+#include "qemu/bitops.h"
 #include "qemu/timer.h"
 #include "qemu/int128.h"
 #include "fpu/softfloat.h"
@@ -34,6 +35,8 @@ enum op {
     OP_FMA,
     OP_SQRT,
     OP_CMP,
+    OP_MAX,
+    OP_CVT,
     OP_MAX_NR,
 };
 
@@ -45,6 +48,8 @@ static const char * const op_names[] = {
     [OP_FMA] = "mulAdd",
     [OP_SQRT] = "sqrt",
     [OP_CMP] = "cmp",
+    [OP_MAX] = "max",
+    [OP_CVT] = "cvt",
     [OP_MAX_NR] = NULL,
 };
 
@@ -144,7 +149,12 @@ static uint64_t xorshift64star(uint64_t x)
     return x * UINT64_C(2685821657736338717);
 }
 
-static void update_random_ops(int n_ops, enum precision prec)
+/*
+ * "cvt" widens single to double, and narrows double to single and quad to
+ * double.  Keep the inputs of the narrowing conversions within the float32
+ * normal range, so that they are not mostly overflows or underflows.
+ */
+static void update_random_ops(int n_ops, enum precision prec, enum op op)
 {
     int i;
 
@@ -168,6 +178,10 @@ static void update_random_ops(int n_ops, enum precision prec)
             do {
                 r = xorshift64star(r);
             } while (!float64_is_normal(r));
+            if (op == OP_CVT) {
+                r = deposit64(r, 52, 11,
+                              1023 - 126 + extract64(r, 52, 11) % 253);
+            }
             random_ops[i] = r;
             break;
         }
@@ -182,6 +196,11 @@ static void update_random_ops(int n_ops, enum precision prec)
                 lo = xorshift64star(lo);
                 r = make_float128(hi, lo);
             } while (!float128_is_normal(r));
+            if (op == OP_CVT) {
+                hi = deposit64(hi, 48, 15,
+                               16383 - 126 + extract64(hi, 48, 15) % 253);
+                r = make_float128(hi, lo);
+            }
             random_quad_ops[i] = r;
             break;
         }
@@ -238,7 +257,7 @@ static void bench(enum precision prec, enum op op, int n_ops, bool no_neg)
         int64_t t0;
         int i;
 
-        update_random_ops(n_ops, prec);
+        update_random_ops(n_ops, prec, op);
         switch (prec) {
         case PREC_SINGLE:
             fill_random(ops, n_ops, prec, no_neg);
@@ -270,6 +289,12 @@ static void bench(enum precision prec, enum op op, int n_ops, bool no_neg)
                 case OP_CMP:
                     res.u64 = isgreater(a, b);
                     break;
+                case OP_MAX:
+                    res.f = fmaxf(a, b);
+                    break;
+                case OP_CVT:
+                    res.d = a;
+                    break;
                 default:
                     g_assert_not_reached();
                 }
@@ -305,6 +330,12 @@ static void bench(enum precision prec, enum op op, int n_ops, bool no_neg)
                 case OP_CMP:
                     res.u64 = isgreater(a, b);
                     break;
+                case OP_MAX:
+                    res.d = fmax(a, b);
+                    break;
+                case OP_CVT:
+                    res.f = a;
+                    break;
                 default:
                     g_assert_not_reached();
                 }
@@ -340,6 +371,12 @@ static void bench(enum precision prec, enum op op, int n_ops, bool no_neg)
                 case OP_CMP:
                     res.u64 = float32_compare_quiet(a, b, &soft_status);
                     break;
+                case OP_MAX:
+                    res.f32 = float32_max(a, b, &soft_status);
+                    break;
+                case OP_CVT:
+                    res.f64 = float32_to_float64(a, &soft_status);
+                    break;
                 default:
                     g_assert_not_reached();
                 }
@@ -375,6 +412,12 @@ static void bench(enum precision prec, enum op op, int n_ops, bool no_neg)
                 case OP_CMP:
                     res.u64 = float64_compare_quiet(a, b, &soft_status);
                     break;
+                case OP_MAX:
+                    res.f64 = float64_max(a, b, &soft_status);
+                    break;
+                case OP_CVT:
+                    res.f32 = float64_to_float32(a, &soft_status);
+                    break;
                 default:
                     g_assert_not_reached();
                 }
@@ -410,6 +453,12 @@ static void bench(enum precision prec, enum op op, int n_ops, bool no_neg)
                 case OP_CMP:
                     res.u64 = float128_compare_quiet(a, b, &soft_status);
                     break;
+                case OP_MAX:
+                    res.f128 = float128_max(a, b, &soft_status);
+                    break;
+                case OP_CVT:
+                    res.f64 = float128_to_float64(a, &soft_status);
+                    break;
                 default:
                     g_assert_not_reached();
                 }
@@ -448,6 +497,8 @@ GEN_BENCH_ALL_TYPES(mul, OP_MUL, 2)
 GEN_BENCH_ALL_TYPES(div, OP_DIV, 2)
 GEN_BENCH_ALL_TYPES(fma, OP_FMA, 3)
 GEN_BENCH_ALL_TYPES(cmp, OP_CMP, 2)
+GEN_BENCH_ALL_TYPES(max, OP_MAX, 2)
+GEN_BENCH_ALL_TYPES(cvt, OP_CVT, 1)
 #undef GEN_BENCH_ALL_TYPES
 
 #define GEN_BENCH_ALL_TYPES_NO_NEG(name, op, n)                         \
@@ -480,6 +531,8 @@ static const bench_func_t bench_funcs[OP_MAX_NR][PREC_MAX_NR] = {
     GEN_BENCH_FUNCS(fma, OP_FMA),
     GEN_BENCH_FUNCS(sqrt, OP_SQRT),
     GEN_BENCH_FUNCS(cmp, OP_CMP),
+    GEN_BENCH_FUNCS(max, OP_MAX),
+    GEN_BENCH_FUNCS(cvt, OP_CVT),
 };
 
 #undef GEN_BENCH_FUNCS
@@ -0,0 +1,203 @@
+/*
+ * fp-test-minmax.c - test QEMU's softfloat min/max on numerical inputs
+ *
+ * Berkeley testfloat has no min/max operations, so fp-test cannot cover
+ * them.  Check float32/float64 min, max, minnum, maxnum, minnummag and
+ * maxnummag against the host's ordering of the same values, both with
+ * no flags set and with inexact already set (the hardfloat state).  NaN
+ * inputs are not generated: their result is target-specific.
+ *
+ * License: GNU GPL, version 2 or later.
+ *   See the COPYING file in the top-level directory.
+ */
+#ifndef HW_POISON_H
+#error Must define HW_POISON_H to work around TARGET_* poisoning
+#endif
+
+#include "qemu/osdep.h"
+#include <math.h>
+#include "fpu/softfloat.h"
+
+typedef union {
+    float f;
+    uint32_t i;
+} ufloat32;
+
+typedef union {
+    double d;
+    uint64_t i;
+} ufloat64;
+
+typedef float32 (*minmax32_fn)(float32, float32, float_status *);
+typedef float64 (*minmax64_fn)(float64, float64, float_status *);
+
+static const struct {
+    const char *name;
+    minmax32_fn fn32;
+    minmax64_fn fn64;
+    bool ismin;
+    bool ismag;
+} ops[] = {
+    { "min", float32_min, float64_min, true, false },
+    { "max", float32_max, float64_max, false, false },
+    { "minnum", float32_minnum, float64_minnum, true, false },
+    { "maxnum", float32_maxnum, float64_maxnum, false, false },
+    { "minnummag", float32_minnummag, float64_minnummag, true, true },
+    { "maxnummag", float32_maxnummag, float64_maxnummag, false, true },
+};
+
+static const uint8_t init_flags[] = { 0, float_flag_inexact };
+
+static const uint32_t special32[] = {
+    0x00000000, 0x00000001, 0x007fffff, 0x00800000, 0x00800001,
+    0x3f7fffff, 0x3f800000, 0x3f800001, 0x7f7fffff, 0x7f800000,
+};
+
+static const uint64_t special64[] = {
+    0x0000000000000000ull, 0x0000000000000001ull, 0x000fffffffffffffull,
+    0x0010000000000000ull, 0x0010000000000001ull, 0x3fefffffffffffffull,
+    0x3ff0000000000000ull, 0x3ff0000000000001ull, 0x7fefffffffffffffull,
+    0x7ff0000000000000ull,
+};
+
+static int errors;
+
+/* Return true if the op should return @b, using host comparisons.  */
+static bool ref_pick_b(double a, double b, bool ismin, bool ismag)
+{
+    int cmp = 0;
+
+    if (ismag) {
+        cmp = (fabs(a) > fabs(b)) - (fabs(a) < fabs(b));
+    }
+    if (cmp == 0) {
+        cmp = (a > b) - (a < b);
+    }
+    if (cmp == 0) {
+        /* Only zeros of opposite sign have different encodings here. */
+        cmp = !!signbit(b) - !!signbit(a);
+    }
+    if (ismin) {
+        cmp = -cmp;
+    }
+    return cmp < 0;
+}
+
+static void report(const char *name, int bits, uint64_t a, uint64_t b,
+                   uint64_t res, uint64_t ref, uint8_t init, uint8_t flags)
+{
+    printf("f%d_%s(%0*" PRIx64 ", %0*" PRIx64 ") with flags %#x:\n"
+           "  sf: %0*" PRIx64 " flags %#x\n"
+           " ref: %0*" PRIx64 " flags %#x\n\n",
+           bits, name, bits / 4, a, bits / 4, b, init,
+           bits / 4, res, flags, bits / 4, ref, init);
+
+    if (++errors == 20) {
+        exit(1);
+    }
+}
+
+static void test32(uint32_t a, uint32_t b)
+{
+    ufloat32 fa = { .i = a }, fb = { .i = b };
+    float_status qsf = {0};
+    int i, j;
+
+    set_float_rounding_mode(float_round_nearest_even, &qsf);
+
+    for (i = 0; i < ARRAY_SIZE(ops); i++) {
+        bool pick_b = ref_pick_b(fa.f, fb.f, ops[i].ismin, ops[i].ismag);
+        uint32_t ref = pick_b ? b : a;
+
+        for (j = 0; j < ARRAY_SIZE(init_flags); j++) {
+            uint32_t res;
+
+            qsf.float_exception_flags = init_flags[j];
+            res = float32_val(ops[i].fn32(make_float32(a), make_float32(b),
+                                          &qsf));
+            if (res != ref || qsf.float_exception_flags != init_flags[j]) {
+                report(ops[i].name, 32, a, b, res, ref, init_flags[j],
+                       qsf.float_exception_flags);
+            }
+        }
+    }
+}
+
+static void test64(uint64_t a, uint64_t b)
+{
+    ufloat64 da = { .i = a }, db = { .i = b };
+    float_status qsf = {0};
+    int i, j;
+
+    set_float_rounding_mode(float_round_nearest_even, &qsf);
+
+    for (i = 0; i < ARRAY_SIZE(ops); i++) {
+        bool pick_b = ref_pick_b(da.d, db.d, ops[i].ismin, ops[i].ismag);
+        uint64_t ref = pick_b ? b : a;
+
+        for (j = 0; j < ARRAY_SIZE(init_flags); j++) {
+            uint64_t res;
+
+            qsf.float_exception_flags = init_flags[j];
+            res = float64_val(ops[i].fn64(make_float64(a), make_float64(b),
+                                          &qsf));
+            if (res != ref || qsf.float_exception_flags != init_flags[j]) {
+                report(ops[i].name, 64, a, b, res, ref, init_flags[j],
+                       qsf.float_exception_flags);
+            }
+        }
+    }
+}
+
+static uint32_t random32(void)
+{
+    uint32_t r;
+
+    do {
+        r = mrand48();
+    } while (float32_is_any_nan(make_float32(r)));
+    return r;
+}
+
+static uint64_t random64(void)
+{
+    uint64_t r;
+
+    do {
+        r = ((uint64_t)mrand48() << 32) | (uint32_t)mrand48();
+    } while (float64_is_any_nan(make_float64(r)));
+    return r;
+}
+
+int main(int ac, char **av)
+{
+    int i, j, si, sj;
+
+    /* Every pair of special values, with each combination of signs. */
+    for (i = 0; i < ARRAY_SIZE(special32); i++) {
+        for (j = 0; j < ARRAY_SIZE(special32); j++) {
+            for (si = 0; si < 2; si++) {
+                for (sj = 0; sj < 2; sj++) {
+                    test32(special32[i] | (uint32_t)si << 31,
+                           special32[j] | (uint32_t)sj << 31);
+                    test64(special64[i] | (uint64_t)si << 63,
+                           special64[j] | (uint64_t)sj << 63);
+                }
+            }
+        }
+    }
+
+    for (i = 0; i < 1000000; i++) {
+        uint32_t a32 = random32();
+        uint64_t a64 = random64();
+
+        test32(a32, random32());
+        test64(a64, random64());
+
+        /* Equal magnitudes, possibly of different sign. */
+        test32(a32, a32 ^ ((uint32_t)(i & 1) << 31));
+        test64(a64, a64 ^ ((uint64_t)(i & 1) << 63));
+    }
+
+    return errors != 0;
+}
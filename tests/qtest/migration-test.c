@@ -2572,11 +2572,48 @@ test_migrate_precopy_tcp_multifd_zstd_start(QTestState *from,
 }
 #endif /* CONFIG_ZSTD */
 
+#ifdef CONFIG_LZ4
+static void *
+test_migrate_precopy_tcp_multifd_lz4_start(QTestState *from,
+                                           QTestState *to)
+{
+    return test_migrate_precopy_tcp_multifd_start_common(from, to, "lz4");
+}
+#endif /* CONFIG_LZ4 */
+
+static void
+test_migrate_multifd_profile_finish(QTestState *from,
+                                    QTestState *to,
+                                    void *opaque)
+{
+    QDict *rsp;
+    QList *phases;
+    const QListEntry *entry;
+    int nphases = 0;
+
+    /* Every profiled phase must have run during a multifd migration */
+    rsp = qtest_qmp(from, "{ 'execute': 'query-migrate-profile' }");
+    phases = qdict_get_qlist(rsp, "return");
+    g_assert(phases);
+
+    QLIST_FOREACH_ENTRY(phases, entry) {
+        QDict *phase = qobject_to(QDict, qlist_entry_obj(entry));
+
+        g_assert(phase);
+        g_assert_cmpint(qdict_get_try_int(phase, "count", 0), >, 0);
+        nphases++;
+    }
+    g_assert_cmpint(nphases, ==, 4);
+
+    qobject_unref(rsp);
+}
+
 static void test_multifd_tcp_none(void)
 {
     MigrateCommon args = {
         .listen_uri = "defer",
         .start_hook = test_migrate_precopy_tcp_multifd_start,
+        .finish_hook = test_migrate_multifd_profile_finish,
         /*
          * Multifd is more complicated than most of the features, it
          * directly takes guest page buffers when sending, make sure
@@ -2607,6 +2644,43 @@ static void test_multifd_tcp_zstd(void)
 }
 #endif
 
+static void test_multifd_tcp_zero_page(bool enabled)
+{
+    const char *opts = enabled ? "-global migration.multifd-zero-page=on" :
+                                 "-global migration.multifd-zero-page=off";
+    MigrateCommon args = {
+        .start = {
+            .opts_source = opts,
+            .opts_target = opts,
+        },
+        .listen_uri = "defer",
+        .start_hook = test_migrate_precopy_tcp_multifd_start,
+        .live = true,
+    };
+    test_precopy_common(&args);
+}
+
+static void test_multifd_tcp_zero_page_on(void)
+{
+    test_multifd_tcp_zero_page(true);
+}
+
+static void test_multifd_tcp_zero_page_off(void)
+{
+    test_multifd_tcp_zero_page(false);
+}
+
+#ifdef CONFIG_LZ4
+static void test_multifd_tcp_lz4(void)
+{
+    MigrateCommon args = {
+        .listen_uri = "defer",
+        .start_hook = test_migrate_precopy_tcp_multifd_lz4_start,
+    };
+    test_precopy_common(&args);
+}
+#endif
+
 #ifdef CONFIG_GNUTLS
 static void *
 test_migrate_multifd_tcp_tls_psk_start_match(QTestState *from,
@@ -3476,12 +3550,20 @@ int main(int argc, char **argv)
         qtest_add_func("/migration/multifd/tcp/plain/cancel",
                        test_multifd_tcp_cancel);
     }
+    qtest_add_func("/migration/multifd/tcp/plain/zero-page/on",
+                   test_multifd_tcp_zero_page_on);
+    qtest_add_func("/migration/multifd/tcp/plain/zero-page/off",
+                   test_multifd_tcp_zero_page_off);
     qtest_add_func("/migration/multifd/tcp/plain/zlib",
                    test_multifd_tcp_zlib);
 #ifdef CONFIG_ZSTD
     qtest_add_func("/migration/multifd/tcp/plain/zstd",
                    test_multifd_tcp_zstd);
 #endif
+#ifdef CONFIG_LZ4
+    qtest_add_func("/migration/multifd/tcp/plain/lz4",
+                   test_multifd_tcp_lz4);
+#endif
 #ifdef CONFIG_GNUTLS
     qtest_add_func("/migration/multifd/tcp/tls/psk/match",
                    test_multifd_tcp_tls_psk_match);
@@ -778,13 +778,14 @@ void aio_context_set_poll_params(AioContext *ctx, int64_t max_ns,
 }
 
 void aio_context_set_aio_params(AioContext *ctx, int64_t max_batch,
-                                Error **errp)
+                                int64_t sqpoll_idle, Error **errp)
 {
     /*
      * No thread synchronization here, it doesn't matter if an incorrect value
      * is used once.
      */
     ctx->aio_max_batch = max_batch;
+    ctx->aio_sqpoll_idle = sqpoll_idle;
 
     aio_notify(ctx);
 }
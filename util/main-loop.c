@@ -192,7 +192,8 @@ static void main_loop_update_params(EventLoopBase *base, Error **errp)
         return;
     }
 
-    aio_context_set_aio_params(qemu_aio_context, base->aio_max_batch, errp);
+    aio_context_set_aio_params(qemu_aio_context, base->aio_max_batch,
+                               base->aio_sqpoll_idle, errp);
     if (*errp) {
         return;
     }